@@ -0,0 +1,141 @@
+#include "animations.h"
+
+#include <any>
+#include <array>
+#include <hyprland/src/config/ConfigManager.hpp>
+#include <hyprland/src/event/EventBus.hpp>
+#include <hyprutils/animation/AnimationConfig.hpp>
+#include <utility>
+#include <vector>
+
+using Hyprutils::Animation::SAnimationPropertyConfig;
+
+namespace animations
+{
+
+struct SDirectionalConfig
+{
+    const char *name;
+    bool special;
+    WP<SAnimationPropertyConfig> node;
+    SP<SAnimationPropertyConfig> horizontal;
+    SP<SAnimationPropertyConfig> vertical;
+    // values the node pointed to before apply_direction, null when not applied
+    WP<SAnimationPropertyConfig> saved_values;
+};
+
+static std::array<SDirectionalConfig, 4> configs = {{
+    {.name = "workspacesIn", .special = false},
+    {.name = "workspacesOut", .special = false},
+    {.name = "specialWorkspaceIn", .special = true},
+    {.name = "specialWorkspaceOut", .special = true},
+}};
+static bool configs_built = false;
+
+// monitor id -> direction, only a handful of monitors so a flat vector is enough
+static std::vector<std::pair<MONITORID, char>> directions;
+
+static std::vector<std::any> listeners;
+
+static SP<SAnimationPropertyConfig> make_variant(const SP<SAnimationPropertyConfig> &values, const char *style)
+{
+    auto variant = makeShared<SAnimationPropertyConfig>(*values);
+    variant->internalStyle = style;
+    variant->overridden = true;
+    variant->pValues = variant;
+    return variant;
+}
+
+void rebuild_directional_configs()
+{
+    restore_configs();
+
+    for (auto &config : configs)
+    {
+        const auto node = g_pConfigManager->getAnimationPropertyConfig(config.name);
+        const auto values = node ? node->pValues.lock() : nullptr;
+
+        config.node = node;
+        config.horizontal = values ? make_variant(values, "slide") : nullptr;
+        config.vertical = values ? make_variant(values, "slidevert") : nullptr;
+    }
+
+    configs_built = true;
+}
+
+char get_direction(MONITORID monitor_id)
+{
+    for (const auto &[id, direction] : directions)
+    {
+        if (id == monitor_id)
+            return direction;
+    }
+    return '\0';
+}
+
+char set_direction(MONITORID monitor_id, char direction)
+{
+    for (auto &[id, current] : directions)
+    {
+        if (id == monitor_id)
+            return std::exchange(current, direction);
+    }
+    directions.emplace_back(monitor_id, direction);
+    return '\0';
+}
+
+bool apply_direction(bool special, char direction)
+{
+    if (direction == '\0')
+        return false;
+
+    if (!configs_built)
+        rebuild_directional_configs();
+
+    const bool horizontal = direction == 'l' || direction == 'r';
+    bool applied = false;
+
+    for (auto &config : configs)
+    {
+        if (config.special != special)
+            continue;
+
+        const auto node = config.node.lock();
+        const auto &variant = horizontal ? config.horizontal : config.vertical;
+        if (!node || !variant)
+            continue;
+
+        if (!config.saved_values)
+            config.saved_values = node->pValues;
+        node->pValues = variant;
+        applied = true;
+    }
+
+    return applied;
+}
+
+void init()
+{
+    // Directional animation configs follow the user's workspace animation
+    listeners = {
+        Event::bus()->m_events.config.reloaded.listen([] { rebuild_directional_configs(); }),
+    };
+}
+
+void exit()
+{
+    listeners.clear();
+}
+
+void restore_configs()
+{
+    for (auto &config : configs)
+    {
+        const auto node = config.node.lock();
+        if (node && config.saved_values)
+            node->pValues = config.saved_values;
+        config.saved_values.reset();
+    }
+}
+
+} // namespace animations
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <hyprland/src/SharedDefs.hpp>
+
+// Directional workspace animations: the slide/slidevert variants of the workspace animation configs
+// are built once per config reload and swapped in by pointer while an animation starts
+namespace animations
+{
+
+// Rebuild the directional variants whenever the config is reloaded
+void init();
+void exit();
+
+// Rebuild the directional variants from the current animation tree, call on config reload
+void rebuild_directional_configs();
+
+// Direction ('l', 'r', 'u', 'd' or '\0') of the workspace change in progress on a monitor
+char get_direction(MONITORID monitor_id);
+// Returns the previous direction so nested changes can restore it
+char set_direction(MONITORID monitor_id, char direction);
+
+// Point the workspace animation configs at the variant for direction until restore_configs is called
+bool apply_direction(bool special, char direction);
+void restore_configs();
+
+} // namespace animations
@@ -1,6 +1,9 @@
 #include "dispatchers.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
+#include <limits>
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/SharedDefs.hpp>
 #include <hyprland/src/debug/log/Logger.hpp>
@@ -17,10 +20,17 @@
 #include <hyprland/src/layout/supplementary/WorkspaceAlgoMatcher.hpp>
 #include <hyprland/src/plugins/PluginAPI.hpp>
 #include <hyprland/src/render/Renderer.hpp>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "globals.h"
+#include "replay.h"
+#include "session.h"
+#include "topology.h"
+#include "trace.h"
 #include "utils.h"
+#include "workspace_pool.h"
 
 #include "overview/globals.hpp"
 
@@ -87,61 +97,105 @@ bool should_use_hyprland_for_floating_focus(const PHLWINDOW &old_window, const P
     return true;
 }
 
-// compare windows by position based on direction to find best window to focus
-bool is_better_window_for_direction(const PHLWINDOW &candidate, const PHLWINDOW &current_best, char direction)
+// Box of window relative to its monitor, so windows on different workspaces can be compared
+CBox get_window_box_on_monitor(const PHLWINDOW &window)
+{
+    CBox box = {window->m_realPosition->goal(), window->m_realSize->goal()};
+    if (window->m_monitor)
+        box.translate(-window->m_monitor->m_position);
+    return box;
+}
+
+// Coordinate of the edge of box a window entering from direction crosses first, smaller is closer
+double get_entry_edge_distance(const CBox &box, char direction)
 {
     switch (direction)
     {
     case 'l':
-        return candidate->m_realPosition->goal().x + candidate->m_realSize->goal().x >
-               current_best->m_realPosition->goal().x + current_best->m_realSize->goal().x;
+        return -(box.x + box.w);
     case 'r':
-        return candidate->m_realPosition->goal().x < current_best->m_realPosition->goal().x;
+        return box.x;
     case 'u':
-        return candidate->m_realPosition->goal().y + candidate->m_realSize->goal().y >
-               current_best->m_realPosition->goal().y + current_best->m_realSize->goal().y;
+        return -(box.y + box.h);
     case 'd':
-        return candidate->m_realPosition->goal().y < current_best->m_realPosition->goal().y;
+        return box.y;
     default:
-        return false;
+        return 0;
     }
 }
 
-// find best window to focus in target workspace based on direction
-PHLWINDOW find_best_window_in_workspace(const std::string &target_workspace_name, char direction)
+// Length of the overlap of both boxes on the axis perpendicular to direction
+double get_perpendicular_overlap(const CBox &a, const CBox &b, char direction)
 {
-    PHLWINDOW target_window = nullptr;
+    if (direction == 'l' || direction == 'r')
+        return std::min(a.y + a.h, b.y + b.h) - std::max(a.y, b.y);
+    else
+        return std::min(a.x + a.w, b.x + b.w) - std::max(a.x, b.x);
+}
 
-    const auto &history = Desktop::History::windowTracker()->fullHistory();
-    for (auto it = history.rbegin(); it != history.rend(); ++it)
+// find best window to focus in target workspace based on direction:
+// the window on the entry edge that lines up best with source_window
+PHLWINDOW find_best_window_in_workspace(const std::string &target_workspace_name, char direction,
+                                        const PHLWINDOW &source_window)
+{
+    const PHLWORKSPACE workspace = g_pCompositor->getWorkspaceByName(target_workspace_name);
+    if (!workspace)
+        return nullptr;
+
+    // If the window is fullscreen, we want to focus it
+    if (workspace->m_hasFullscreenWindow)
     {
-        const auto window = it->lock();
-        if (!window || !window->m_isMapped)
+        const PHLWINDOW fullscreen_window = workspace->getFullscreenWindow();
+        if (fullscreen_window)
+            return fullscreen_window;
+    }
+
+    // only find windows with same floating state as the latest focused window
+    const PHLWINDOW last_window = workspace->getLastFocusedWindow();
+    const bool floating = last_window && last_window->m_isFloating;
+
+    // Hyprland keeps no per-workspace window list, so this is one pass over all windows on every keypress. Still
+    // cheaper than keeping a spatial index in sync with relayouts the plugin is never told about
+    std::vector<std::pair<PHLWINDOW, CBox>> candidates;
+    double entry_edge = std::numeric_limits<double>::max();
+    for (const auto &window : g_pCompositor->m_windows)
+    {
+        if (!window->m_isMapped || window->m_workspace != workspace || window->m_isFloating != floating)
             continue;
 
-        const std::string &window_workspace_name = window->m_workspace->m_name;
+        const CBox box = get_window_box_on_monitor(window);
+        entry_edge = std::min(entry_edge, get_entry_edge_distance(box, direction));
+        candidates.push_back({window, box});
+    }
+
+    if (candidates.empty())
+        return nullptr;
 
-        if (window_workspace_name == target_workspace_name)
+    const CBox source_box = source_window ? get_window_box_on_monitor(source_window) : CBox{};
+    const Vector2D source_center = source_box.middle();
+
+    // Tiles on the entry edge share it up to rounding, anything further in is not a candidate
+    constexpr double EDGE_TOLERANCE = 2.0;
+
+    PHLWINDOW target_window = nullptr;
+    double best_overlap = -std::numeric_limits<double>::max();
+    for (const auto &[window, box] : candidates)
+    {
+        if (get_entry_edge_distance(box, direction) > entry_edge + EDGE_TOLERANCE)
+            continue;
+
+        // without an overlap, fall back to the closest window along the edge
+        double overlap = get_perpendicular_overlap(box, source_box, direction);
+        if (overlap <= 0)
         {
-            // If the window is fullscreen, we want to focus it
-            if (window->isFullscreen())
-            {
-                return window;
-            }
+            const Vector2D delta = box.middle() - source_center;
+            overlap = -((direction == 'l' || direction == 'r') ? std::abs(delta.y) : std::abs(delta.x));
+        }
 
-            if (!target_window)
-            {
-                target_window = window;
-            }
-            // only find windows with same floating state as the latest focused window
-            else if (window->m_isFloating != target_window->m_isFloating)
-            {
-                continue;
-            }
-            else if (is_better_window_for_direction(window, target_window, direction))
-            {
-                target_window = window;
-            }
+        if (!target_window || overlap > best_overlap)
+        {
+            target_window = window;
+            best_overlap = overlap;
         }
     }
 
@@ -254,10 +308,11 @@ SDispatchResult dispatch_workspace(std::string arg)
 
     std::string workspace_name = find_workspace_by_column(target_column);
 
-    // no window found on target workspace, simply switch to it
+    // no window found on target workspace, simply switch to it,
+    // on the row the session snapshot had shown there the first time after a restart
     if (workspace_name.empty())
     {
-        workspace_name = get_workspace_name(target_column, 0);
+        workspace_name = get_workspace_name(target_column, std::max(0, session::take_restored_row(target_column)));
     }
 
     // anim_type = target_column < current_column ? 'l' : 'r';
@@ -339,7 +394,7 @@ SDispatchResult dispatch_movefocus(std::string arg)
         const PHLMONITOR current_monitor = Desktop::focusState()->monitor();
         if (current_monitor)
         {
-            const PHTVIEW view = ht_manager->get_view_from_monitor(current_monitor);
+            const PHTVIEW& view = ht_manager->get_view_from_monitor(current_monitor);
             if (view && view->active)
             {
                 std::string dir;
@@ -367,12 +422,6 @@ SDispatchResult dispatch_movefocus(std::string arg)
         }
     }
 
-	// TODO: add a config value to support horizontal movefocus to adjacent workspaces
-	if (direction == 'l' || direction == 'r') {
-		HyprlandAPI::invokeHyprctlCommand("dispatch", "movefocus " + arg);
-		return {};
-	}
-
     const auto PLASTWINDOW = Desktop::focusState()->window();
 
     // If there is a window and a window to move focus to, handle it by hyprland
@@ -405,10 +454,17 @@ SDispatchResult dispatch_movefocus(std::string arg)
 
     std::string target_workspace_name = get_workspace_in_direction(direction);
 
+    // No column on that side, let hyprland move on to the next monitor if there is one
+    if (target_workspace_name.empty() && (direction == 'l' || direction == 'r'))
+    {
+        HyprlandAPI::invokeHyprctlCommand("dispatch", "movefocus " + arg);
+        return {};
+    }
+
     if (!target_workspace_name.empty())
     {
         // Find the window in the workspace in direction
-        PHLWINDOW target_window = find_best_window_in_workspace(target_workspace_name, direction);
+        PHLWINDOW target_window = find_best_window_in_workspace(target_workspace_name, direction, PLASTWINDOW);
 
         if (target_window)
         {
@@ -633,18 +689,27 @@ SDispatchResult dispatch_cleancurrentcolumn(std::string arg)
     const std::string &current_workspace_name = Desktop::focusState()->monitor()->m_activeWorkspace->m_name;
     int current_column = name_to_column(current_workspace_name);
 
+    // empty workspaces kept warm should not take up a slot, and must not survive under a name that is about to
+    // be given to another workspace
+    workspace_pool::release_column(current_column);
+
     // pair of (name, id)
     // include id because hyprland needs id to rename workspace
     std::set<std::pair<std::string, int>> workspaces_in_column;
 
     for (const auto &workspace : g_pCompositor->getWorkspaces())
     {
+        // released workspaces are gone once hyprland dropped them
+        if (!workspace)
+            continue;
+
         int workspace_column = name_to_column(workspace->m_name);
 
         // skip special workspaces
         if (workspace_column == -1)
             continue;
 
+        // anything still alive keeps its slot, so no two workspaces end up with the same name
         if (workspace_column == current_column)
         {
             workspaces_in_column.insert({workspace->m_name, workspace->m_id});
@@ -670,6 +735,7 @@ SDispatchResult dispatch_cleancurrentcolumn(std::string arg)
         counter++;
     }
 
+    topology::changed();
     return {};
 }
 
@@ -712,6 +778,98 @@ SDispatchResult dispatch_insertworkspace(std::string arg)
     HyprlandAPI::invokeHyprctlCommand("dispatch", "workspace name:" + new_workspace_name);
     // anim_type = '\0';
 
+    topology::changed();
+    return {};
+}
+
+// Column ids that have at least one workspace on monitor, in display order
+std::vector<int> get_monitor_columns(const PHLMONITOR &monitor)
+{
+    std::set<int> columns;
+    for (const auto &workspace : g_pCompositor->getWorkspaces())
+    {
+        if (workspace->m_monitor != monitor)
+            continue;
+
+        int workspace_column = name_to_column(workspace->m_name);
+
+        // skip special workspaces
+        if (workspace_column == -1)
+            continue;
+
+        if (workspace_pool::is_parked(workspace.lock()))
+            continue;
+
+        columns.insert(workspace_column);
+    }
+
+    return {columns.begin(), columns.end()};
+}
+
+// The column next to current_column on monitor, or -1 if it is already at that edge
+int find_neighbour_column(const PHLMONITOR &monitor, int current_column, bool search_left)
+{
+    const auto columns = get_monitor_columns(monitor);
+    const auto it = std::ranges::find(columns, current_column);
+    if (it == columns.end())
+        return -1;
+
+    if (search_left)
+        return it == columns.begin() ? -1 : *std::prev(it);
+    else
+        return std::next(it) == columns.end() ? -1 : *std::next(it);
+}
+
+// Apply a precomputed set of renames in one go. Names may be swapped between entries, hyprland does not check
+// for duplicates so there is no need to go through temporary names like the hyprctl path does
+void apply_workspace_renames(const std::vector<std::pair<PHLWORKSPACE, std::string>> &renames)
+{
+    std::set<PHLMONITOR> monitors;
+    for (const auto &[workspace, name] : renames)
+    {
+        if (workspace->m_name == name)
+            continue;
+
+        g_pCompositor->renameWorkspace(workspace->m_id, name);
+        monitors.insert(workspace->m_monitor.lock());
+    }
+
+    for (const auto &monitor : monitors)
+    {
+        if (monitor)
+            g_pHyprRenderer->damageMonitor(monitor);
+    }
+
+    topology::changed();
+}
+
+// Move the current sub-workspace into the same row of the neighbouring column, swapping with whatever is there
+SDispatchResult move_workspace_horizontal(bool move_left)
+{
+    const PHLMONITOR monitor = Desktop::focusState()->monitor();
+    if (!monitor || !monitor->m_activeWorkspace)
+        return {.success = false, .error = "No active workspace"};
+
+    const PHLWORKSPACE current_workspace = monitor->m_activeWorkspace;
+    int current_column = name_to_column(current_workspace->m_name);
+    int current_index = name_to_index(current_workspace->m_name);
+    if (current_column == -1)
+        return {.success = false, .error = "Current workspace is not part of a column"};
+
+    int target_column = find_neighbour_column(monitor, current_column, move_left);
+    if (target_column == -1)
+        return {};
+
+    const std::string target_workspace_name = get_workspace_name(target_column, current_index);
+
+    std::vector<std::pair<PHLWORKSPACE, std::string>> renames;
+    renames.push_back({current_workspace, target_workspace_name});
+
+    const PHLWORKSPACE target_workspace = g_pCompositor->getWorkspaceByName(target_workspace_name);
+    if (target_workspace)
+        renames.push_back({target_workspace, current_workspace->m_name});
+
+    apply_workspace_renames(renames);
     return {};
 }
 
@@ -728,9 +886,12 @@ SDispatchResult dispatch_moveworkspace(std::string arg)
     {
         dy = 1;
     }
+    else if (direction == 'l' || direction == 'r')
+    {
+        return move_workspace_horizontal(direction == 'l');
+    }
     else
     {
-        // TODO: support moving workspace to left/right column
         return {.success = false, .error = "Invalid direction for moveworkspace"};
     }
 
@@ -750,6 +911,9 @@ SDispatchResult dispatch_moveworkspace(std::string arg)
         if (workspace_column == -1)
             continue;
 
+        if (workspace_pool::is_parked(workspace.lock()))
+            continue;
+
         if (workspace_column == current_column && workspace_index == current_index + dy)
         {
             std::string target_workspace_name = workspace->m_name;
@@ -770,6 +934,7 @@ SDispatchResult dispatch_moveworkspace(std::string arg)
             HyprlandAPI::invokeHyprctlCommand("dispatch", "workspace name:" + target_workspace_name);
             // anim_type = '\0';
 
+            topology::changed();
             return {};
         }
     }
@@ -777,36 +942,79 @@ SDispatchResult dispatch_moveworkspace(std::string arg)
     return {};
 }
 
-SDispatchResult dispatch_movecurrentcolumntomonitor(std::string arg)
+SDispatchResult dispatch_movecolumn(std::string arg)
 {
-    const auto &current_workspace_name = Desktop::focusState()->monitor()->m_activeWorkspace->m_name;
-    const auto current_column = name_to_column(current_workspace_name);
+    char direction = parse_move_arg(arg);
+    if (direction != 'l' && direction != 'r')
+        return {.success = false, .error = "Invalid direction for movecolumn"};
 
-    // Here we move other workspaces in the column first, then the current one
-    // This is because Hyprland uses current workspace's l/r/u/d to determine the
-    // target monitor
-    for (const auto &workspace : g_pCompositor->getWorkspaces())
+    const PHLMONITOR monitor = Desktop::focusState()->monitor();
+    if (!monitor || !monitor->m_activeWorkspace)
+        return {.success = false, .error = "No active workspace"};
+
+    int current_column = name_to_column(monitor->m_activeWorkspace->m_name);
+    if (current_column == -1)
+        return {.success = false, .error = "Current workspace is not part of a column"};
+
+    int target_column = find_neighbour_column(monitor, current_column, direction == 'l');
+    if (target_column == -1)
+        return {};
+
+    // Swap the column ids of both columns, keeping every sub-workspace in its row
+    std::vector<std::pair<PHLWORKSPACE, std::string>> renames;
+    for (const auto &workspace : g_pCompositor->getWorkspacesCopy())
     {
-        // do not consider special workspaces
-        if (workspace->m_name.starts_with("special"))
+        if (!workspace || workspace->m_isSpecialWorkspace)
             continue;
 
-        const auto workspace_column = name_to_column(workspace->m_name);
+        int workspace_column = name_to_column(workspace->m_name);
+        int workspace_index = name_to_index(workspace->m_name);
 
-        // skip special workspaces
-        if (workspace_column == -1)
+        if (workspace_column == current_column)
+            renames.push_back({workspace, get_workspace_name(target_column, workspace_index)});
+        else if (workspace_column == target_column)
+            renames.push_back({workspace, get_workspace_name(current_column, workspace_index)});
+    }
+
+    apply_workspace_renames(renames);
+    return {};
+}
+
+SDispatchResult dispatch_movecurrentcolumntomonitor(std::string arg)
+{
+    const PHLMONITOR source_monitor = Desktop::focusState()->monitor();
+    if (!source_monitor || !source_monitor->m_activeWorkspace)
+        return {.success = false, .error = "No active workspace"};
+
+    const PHLWORKSPACE current_workspace = source_monitor->m_activeWorkspace;
+    const auto current_column = name_to_column(current_workspace->m_name);
+    if (current_column == -1)
+        return {.success = false, .error = "Current workspace is not part of a column"};
+
+    // Resolve the target once, relative to the monitor the column starts on. Resolving per workspace would shift
+    // as the active workspace moves
+    const PHLMONITOR target_monitor = g_pCompositor->getMonitorFromString(arg);
+    if (!target_monitor)
+        return {.success = false, .error = "Target monitor not found"};
+    if (target_monitor == source_monitor)
+        return {};
+
+    // Move the rest of the column without warping the cursor, then the current workspace last so the source
+    // monitor only picks a new active workspace once
+    for (const auto &workspace : g_pCompositor->getWorkspacesCopy())
+    {
+        if (!workspace || workspace->m_isSpecialWorkspace || workspace == current_workspace)
+            continue;
+        if (workspace->m_monitor == target_monitor || name_to_column(workspace->m_name) != current_column)
             continue;
 
-        // if (workspace_column == current_column)
-        if (workspace->m_name != current_workspace_name && workspace_column == current_column)
-        {
-            HyprlandAPI::invokeHyprctlCommand("dispatch",
-                                              "moveworkspacetomonitor name:" + workspace->m_name + " " + arg);
-        }
+        g_pCompositor->moveWorkspaceToMonitor(workspace, target_monitor, true);
     }
 
-    // Then move current workspace
-    HyprlandAPI::invokeHyprctlCommand("dispatch", "movecurrentworkspacetomonitor " + arg);
+    g_pCompositor->moveWorkspaceToMonitor(current_workspace, target_monitor);
+
+    g_pHyprRenderer->damageMonitor(source_monitor);
+    g_pHyprRenderer->damageMonitor(target_monitor);
 
     return {};
 }
@@ -838,17 +1046,22 @@ SDispatchResult dispatch_togglefocusmode(std::string arg)
 
 void addDispatchers()
 {
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:workspace", dispatch_workspace);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movefocus", dispatch_movefocus);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movewindow", dispatch_movewindow);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movetoworkspace", dispatch_movetoworkspace);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movetoworkspacesilent", dispatch_movetoworkspacesilent);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:cleancurrentcolumn", dispatch_cleancurrentcolumn);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:insertworkspace", dispatch_insertworkspace);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:moveworkspace", dispatch_moveworkspace);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movecurrentcolumntomonitor", dispatch_movecurrentcolumntomonitor);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:movefocustomonitor", dispatch_movefocustomonitor);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:togglefocusmode", dispatch_togglefocusmode);
+    replay::add_dispatcher("hyprtile:workspace", dispatch_workspace);
+    replay::add_dispatcher("hyprtile:movefocus", dispatch_movefocus);
+    replay::add_dispatcher("hyprtile:movewindow", dispatch_movewindow);
+    replay::add_dispatcher("hyprtile:movetoworkspace", dispatch_movetoworkspace);
+    replay::add_dispatcher("hyprtile:movetoworkspacesilent", dispatch_movetoworkspacesilent);
+    replay::add_dispatcher("hyprtile:cleancurrentcolumn", dispatch_cleancurrentcolumn);
+    replay::add_dispatcher("hyprtile:insertworkspace", dispatch_insertworkspace);
+    replay::add_dispatcher("hyprtile:moveworkspace", dispatch_moveworkspace);
+    replay::add_dispatcher("hyprtile:movecolumn", dispatch_movecolumn);
+    replay::add_dispatcher("hyprtile:movecurrentcolumntomonitor", dispatch_movecurrentcolumntomonitor);
+    replay::add_dispatcher("hyprtile:movefocustomonitor", dispatch_movefocustomonitor);
+    replay::add_dispatcher("hyprtile:togglefocusmode", dispatch_togglefocusmode);
+
+    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:trace", trace::dispatch_trace);
+    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:record", replay::dispatch_record);
+    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:replay", replay::dispatch_replay);
 }
 
 } // namespace dispatchers
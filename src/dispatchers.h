@@ -19,6 +19,7 @@ SDispatchResult dispatch_movetoworkspacesilent(std::string arg);
 SDispatchResult dispatch_cleancurrentcolumn(std::string arg);
 SDispatchResult dispatch_insertworkspace(std::string arg);
 SDispatchResult dispatch_moveworkspace(std::string arg);
+SDispatchResult dispatch_movecolumn(std::string arg);
 SDispatchResult dispatch_movecurrentcolumntomonitor(std::string arg);
 SDispatchResult dispatch_movefocustomonitor(std::string arg);
 SDispatchResult dispatch_togglefocusmode(std::string arg);
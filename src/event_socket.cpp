@@ -0,0 +1,184 @@
+#include "event_socket.h"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/debug/log/Logger.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <list>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+namespace event_socket
+{
+
+// A subscriber that can't take this much is not reading, drop it rather than buffer forever
+constexpr size_t MAX_PENDING = 64 * 1024;
+
+struct SClient
+{
+    int fd = -1;
+    wl_event_source *source = nullptr;
+    std::string pending;
+};
+
+static int server_fd = -1;
+static wl_event_source *server_source = nullptr;
+static std::string socket_path;
+static std::list<SClient> clients;
+
+static void remove_client(SClient *client)
+{
+    if (client->source)
+        wl_event_source_remove(client->source);
+    close(client->fd);
+    clients.remove_if([client](const SClient &c) { return &c == client; });
+}
+
+// Write as much as the socket takes, false if the client is gone
+static bool flush(SClient &client)
+{
+    while (!client.pending.empty())
+    {
+        const ssize_t written = send(client.fd, client.pending.data(), client.pending.size(), MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        client.pending.erase(0, written);
+    }
+
+    // only wake up for writability while there is something left to send
+    wl_event_source_fd_update(client.source, client.pending.empty() ? WL_EVENT_READABLE
+                                                                    : WL_EVENT_READABLE | WL_EVENT_WRITABLE);
+    return true;
+}
+
+static int on_client_event(int fd, uint32_t mask, void *data)
+{
+    auto *client = (SClient *)data;
+
+    if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR))
+    {
+        remove_client(client);
+        return 0;
+    }
+
+    if (mask & WL_EVENT_READABLE)
+    {
+        // subscribers have nothing to say, drain whatever they send and watch for EOF
+        char buffer[256];
+        const ssize_t len = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            remove_client(client);
+            return 0;
+        }
+    }
+
+    if ((mask & WL_EVENT_WRITABLE) && !flush(*client))
+        remove_client(client);
+
+    return 0;
+}
+
+static int on_connect(int fd, uint32_t mask, void *data)
+{
+    const int client_fd = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (client_fd < 0)
+        return 0;
+
+    SClient &client = clients.emplace_back();
+    client.fd = client_fd;
+    client.source =
+        wl_event_loop_add_fd(g_pCompositor->m_wlEventLoop, client_fd, WL_EVENT_READABLE, on_client_event, &client);
+
+    return 0;
+}
+
+void init()
+{
+    const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+    const char *signature = getenv("HYPRLAND_INSTANCE_SIGNATURE");
+    if (!runtime_dir || !signature)
+        return;
+
+    socket_path = std::string(runtime_dir) + "/hypr/" + signature + "/.hyprtile.sock";
+
+    sockaddr_un address = {.sun_family = AF_UNIX};
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        Log::logger->log(Log::ERR, "[hyprtile] event socket path too long: {}", socket_path);
+        return;
+    }
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    server_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server_fd < 0)
+        return;
+
+    // a previous instance of the plugin may have left it behind
+    unlink(socket_path.c_str());
+
+    if (bind(server_fd, (sockaddr *)&address, SUN_LEN(&address)) < 0 || listen(server_fd, 16) < 0)
+    {
+        Log::logger->log(Log::ERR, "[hyprtile] failed to open event socket {}: {}", socket_path, strerror(errno));
+        close(server_fd);
+        server_fd = -1;
+        return;
+    }
+
+    server_source = wl_event_loop_add_fd(g_pCompositor->m_wlEventLoop, server_fd, WL_EVENT_READABLE, on_connect,
+                                         nullptr);
+}
+
+void exit()
+{
+    while (!clients.empty())
+        remove_client(&clients.front());
+
+    if (server_source)
+        wl_event_source_remove(server_source);
+    server_source = nullptr;
+
+    if (server_fd >= 0)
+    {
+        close(server_fd);
+        unlink(socket_path.c_str());
+    }
+    server_fd = -1;
+}
+
+void post(const std::string &event, const std::string &data)
+{
+    if (clients.empty())
+        return;
+
+    const std::string line = event + ">>" + data + "\n";
+
+    for (auto it = clients.begin(); it != clients.end();)
+    {
+        SClient &client = *it++;
+        if (client.pending.size() + line.size() > MAX_PENDING)
+        {
+            Log::logger->log(Log::WARN, "[hyprtile] dropping event socket subscriber that stopped reading");
+            remove_client(&client);
+            continue;
+        }
+
+        client.pending += line;
+        if (!flush(client))
+            remove_client(&client);
+    }
+}
+
+} // namespace event_socket
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+// Line-delimited `event>>data` stream of hyprtile's own events on
+// $XDG_RUNTIME_DIR/hypr/$HYPRLAND_INSTANCE_SIGNATURE/.hyprtile.sock, in the same format as Hyprland's socket2
+namespace event_socket
+{
+
+void init();
+void exit();
+
+// Queue a line for every subscriber. Never blocks, subscribers that fall too far behind are dropped
+void post(const std::string &event, const std::string &data);
+
+} // namespace event_socket
@@ -8,9 +8,18 @@
 #include <hyprland/src/render/Renderer.hpp>
 #include <hyprutils/animation/AnimatedVariable.hpp>
 
+#include "animations.h"
 #include "dispatchers.h"
+#include "event_socket.h"
 #include "globals.h"
+#include "placement.h"
+#include "replay.h"
+#include "session.h"
+#include "symbols.h"
+#include "topology.h"
+#include "trace.h"
 #include "utils.h"
+#include "workspace_pool.h"
 
 // Overview module
 #include "overview/globals.hpp"
@@ -23,8 +32,6 @@ APICALL EXPORT std::string PLUGIN_API_VERSION()
     return HYPRLAND_API_VERSION;
 }
 
-char anim_type = '\0';
-
 inline CFunctionHook *g_pChangeWorkspaceHook = nullptr;
 typedef void (*origChangeWorkspace)(CMonitor *, const PHLWORKSPACE &, bool, bool, bool);
 void hk_changeWorkspace(CMonitor *thisptr, const PHLWORKSPACE &pWorkspace, bool internal, bool noMouseMove,
@@ -44,32 +51,32 @@ void hk_changeWorkspace(CMonitor *thisptr, const PHLWORKSPACE &pWorkspace, bool
     int target_column = name_to_column(target_workspace_name);
     int target_index = name_to_index(target_workspace_name);
 
+    char direction;
     if (current_column == target_column)
     {
-        if (current_index < target_index)
-        {
-            anim_type = 'd';
-        }
-        else
-        {
-            anim_type = 'u';
-        }
+        direction = current_index < target_index ? 'd' : 'u';
     }
     else
     {
-        if (current_column < target_column)
-        {
-            anim_type = 'r';
-        }
-        else
-        {
-            anim_type = 'l';
-        }
+        direction = current_column < target_column ? 'r' : 'l';
     }
 
+    // direction is scoped to this monitor, so changes on other monitors can't pick it up
+    const char previous_direction = animations::set_direction(thisptr->m_id, direction);
+
+    // hold the workspace we leave so it survives the switch if it is empty
+    const PHLWORKSPACE previous_workspace = thisptr->m_activeWorkspace;
+
     (*(origChangeWorkspace)g_pChangeWorkspaceHook->m_original)(thisptr, pWorkspace, internal, noMouseMove, noFocus);
 
-    anim_type = '\0';
+    animations::set_direction(thisptr->m_id, previous_direction);
+
+    // internal switches, like the overview peeking at the hovered workspace and back, never show the row
+    if (!internal)
+        topology::note_active(thisptr->m_activeWorkspace);
+
+    if (!internal && previous_workspace != thisptr->m_activeWorkspace)
+        workspace_pool::park(previous_workspace);
 }
 
 inline CFunctionHook *g_pChangeWorkspaceIDHook = nullptr;
@@ -100,33 +107,25 @@ void hk_startAnimation(CDesktopAnimationManager *thisptr, PHLWORKSPACE ws,
         instant = true;
     }
 
-    auto config = ws->m_alpha->getConfig();
-    auto &style = config->pValues->internalStyle;
-    auto original_style = config->pValues->internalStyle;
-
-    switch (anim_type)
+    const char direction = animations::get_direction(ws->monitorID());
+    switch (direction)
     {
     case 'l':
-        left = false;
-        style = "slide";
-        break;
-    case 'r':
-        left = true;
-        style = "slide";
-        break;
     case 'u':
         left = false;
-        style = "slidevert";
         break;
+    case 'r':
     case 'd':
         left = true;
-        style = "slidevert";
         break;
     }
 
+    const bool overridden = animations::apply_direction(ws->m_isSpecialWorkspace, direction);
+
     (*(origStartAnimation)g_pStartAnimationHook->m_original)(thisptr, ws, type, left, instant);
 
-    style = original_style;
+    if (overridden)
+        animations::restore_configs();
 }
 
 inline CFunctionHook *g_pFindAvailableDefaultWSHook = nullptr;
@@ -158,6 +157,7 @@ WORKSPACEID hk_findAvailableDefaultWS(CMonitor *thisptr)
 APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle)
 {
     PHANDLE = handle;
+    const uint64_t load_begin = trace::now_ns();
 
     const std::string COMPOSITOR_HASH = __hyprland_api_get_hash();
     const std::string CLIENT_HASH = __hyprland_api_get_client_hash();
@@ -174,37 +174,62 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle)
                                  "\nClient Hash: " + CLIENT_HASH);
     }
 
-    // Function Hooks
-    // static const auto CHANGE_WORKSPACE = HyprlandAPI::findFunctionsByName(PHANDLE, "changeWorkspace");
-    static const auto CHANGE_WORKSPACE_ID =
-        HyprlandAPI::findFunctionsByName(PHANDLE, "_ZN8CMonitor15changeWorkspaceERKlbbb");
+    // Function Hooks, resolved from the symbol cache of this compositor build when possible
+    const uint64_t hooks_begin = trace::now_ns();
+    static const auto CHANGE_WORKSPACE_ID = symbols::find("_ZN8CMonitor15changeWorkspaceERKlbbb");
     g_pChangeWorkspaceIDHook =
-        HyprlandAPI::createFunctionHook(PHANDLE, CHANGE_WORKSPACE_ID[0].address, (void *)&hk_changeWorkspaceID);
+        HyprlandAPI::createFunctionHook(PHANDLE, CHANGE_WORKSPACE_ID.address, (void *)&hk_changeWorkspaceID);
     g_pChangeWorkspaceIDHook->hook();
 
-    static const auto CHANGE_WORKSPACE = HyprlandAPI::findFunctionsByName(
-        PHANDLE, "_ZN8CMonitor15changeWorkspaceERKN9Hyprutils6Memory14CSharedPointerI10CWorkspaceEEbbb");
+    static const auto CHANGE_WORKSPACE =
+        symbols::find("_ZN8CMonitor15changeWorkspaceERKN9Hyprutils6Memory14CSharedPointerI10CWorkspaceEEbbb");
     g_pChangeWorkspaceHook =
-        HyprlandAPI::createFunctionHook(PHANDLE, CHANGE_WORKSPACE[0].address, (void *)&hk_changeWorkspace);
+        HyprlandAPI::createFunctionHook(PHANDLE, CHANGE_WORKSPACE.address, (void *)&hk_changeWorkspace);
     g_pChangeWorkspaceHook->hook();
 
-    static const auto START_ANIMATION = HyprlandAPI::findFunctionsByName(PHANDLE, "startAnimation");
+    static const auto START_ANIMATION = symbols::find("startAnimation");
     g_pStartAnimationHook =
-        HyprlandAPI::createFunctionHook(PHANDLE, START_ANIMATION[0].address, (void *)&hk_startAnimation);
+        HyprlandAPI::createFunctionHook(PHANDLE, START_ANIMATION.address, (void *)&hk_startAnimation);
     g_pStartAnimationHook->hook();
 
-    static const auto FIND_AVAILABLE_DEFAULT_WS = HyprlandAPI::findFunctionsByName(PHANDLE, "findAvailableDefaultWS");
-    g_pFindAvailableDefaultWSHook = HyprlandAPI::createFunctionHook(PHANDLE, FIND_AVAILABLE_DEFAULT_WS[0].address,
+    static const auto FIND_AVAILABLE_DEFAULT_WS = symbols::find("findAvailableDefaultWS");
+    g_pFindAvailableDefaultWSHook = HyprlandAPI::createFunctionHook(PHANDLE, FIND_AVAILABLE_DEFAULT_WS.address,
                                                                     (void *)&hk_findAvailableDefaultWS);
     g_pFindAvailableDefaultWSHook->hook();
+    trace::record_load("load:hooks", hooks_begin, trace::now_ns());
+
+    workspace_pool::init_config();
+    session::init_config();
+
+    animations::init();
 
     // Dispatchers
     dispatchers::addDispatchers();
 
+    // hyprctl hyprtile:topology and the event socket publishing its changes
+    event_socket::init();
+    topology::init();
+
+    // plugin:hyprtile:rule, registered before the config is loaded so the rules get parsed
+    placement::init();
+
     // Initialize overview module
+    const uint64_t overview_begin = trace::now_ns();
     overview::init();
+    trace::record_load("load:overview", overview_begin, trace::now_ns());
 
+    const uint64_t config_begin = trace::now_ns();
     HyprlandAPI::reloadConfig();
+    trace::record_load("load:config", config_begin, trace::now_ns());
+
+    // needs the session config, so only after it has been loaded
+    session::init();
+
+    symbols::save();
+    const uint64_t load_end = trace::now_ns();
+    trace::record_load("load", load_begin, load_end);
+    Log::logger->log(LOG, "[hyprtile] loaded in {:.2f}ms, {} hook symbols cached, {} resolved",
+                     (load_end - load_begin) / 1e6, symbols::cache_hits(), symbols::cache_misses());
 
     return {"hyprtile", "tiled workspace management with overview", "ausummer", "1.0"};
 }
@@ -213,4 +238,13 @@ APICALL EXPORT void PLUGIN_EXIT()
 {
     // Cleanup overview module
     overview::exit();
+
+    replay::exit();
+    placement::exit();
+    session::exit();
+    topology::exit();
+    event_socket::exit();
+    workspace_pool::clear();
+    animations::exit();
+    animations::restore_configs();
 }
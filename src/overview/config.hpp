@@ -37,4 +37,55 @@ inline T value(std::string config)
     return **cache[config];
 }
 
+// The overview settings a reload can change, compared against the previous reload so only what changed is redone
+struct Snapshot {
+    std::string layout;
+
+    // What the layouts compute their tiles from
+    struct Geometry {
+        float gap_size;
+        float border_size;
+        float focus_scale;
+        float column_min_tile_width;
+        Hyprlang::INT grid_rows;
+        Hyprlang::INT grid_cols;
+        Hyprlang::INT grid_gaps_use_aspect_ratio;
+        float linear_height;
+
+        bool operator==(const Geometry&) const = default;
+    } geometry;
+
+    // Read every frame, a change only needs a redraw
+    struct Colours {
+        Hyprlang::INT bg_color;
+        float filter_dim;
+        Hyprlang::INT cycle_bg_color;
+
+        bool operator==(const Colours&) const = default;
+    } colours;
+};
+
+inline Snapshot snapshot() {
+    return {
+        .layout = value<Hyprlang::STRING>("layout"),
+        .geometry =
+            {
+                .gap_size = value<Hyprlang::FLOAT>("gap_size"),
+                .border_size = value<Hyprlang::FLOAT>("border_size"),
+                .focus_scale = value<Hyprlang::FLOAT>("focus_scale"),
+                .column_min_tile_width = value<Hyprlang::FLOAT>("column:min_tile_width"),
+                .grid_rows = value<Hyprlang::INT>("grid:rows"),
+                .grid_cols = value<Hyprlang::INT>("grid:cols"),
+                .grid_gaps_use_aspect_ratio = value<Hyprlang::INT>("grid:gaps_use_aspect_ratio"),
+                .linear_height = value<Hyprlang::FLOAT>("linear:height"),
+            },
+        .colours =
+            {
+                .bg_color = value<Hyprlang::INT>("bg_color"),
+                .filter_dim = value<Hyprlang::FLOAT>("filter_dim"),
+                .cycle_bg_color = value<Hyprlang::INT>("cycle:bg_color"),
+            },
+    };
+}
+
 } // namespace HTConfig
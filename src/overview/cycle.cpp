@@ -0,0 +1,341 @@
+#include "cycle.hpp"
+
+#include <algorithm>
+#include <format>
+#include <linux/input-event-codes.h>
+#include <wayland-server-core.h>
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/config/ConfigValue.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/desktop/state/FocusState.hpp>
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/managers/SeatManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprland/src/render/Renderer.hpp>
+#include <hyprland/src/render/pass/BorderPassElement.hpp>
+#include <hyprland/src/render/pass/RectPassElement.hpp>
+
+#include "../utils.h"
+#include "config.hpp"
+
+// ========== MRU ring ==========
+
+void HTMruRing::touch(const PHLWINDOW& window) {
+    if (window == nullptr)
+        return;
+
+    const auto it = positions.find(window.get());
+    if (it != positions.end()) {
+        order.splice(order.begin(), order, it->second);
+        return;
+    }
+    order.emplace_front(window);
+    positions[window.get()] = order.begin();
+}
+
+void HTMruRing::remove(const PHLWINDOW& window) {
+    const auto it = positions.find(window.get());
+    if (it == positions.end())
+        return;
+    order.erase(it->second);
+    positions.erase(it);
+}
+
+void HTMruRing::clear() {
+    order.clear();
+    positions.clear();
+}
+
+const std::list<PHLWINDOWREF>& HTMruRing::windows() const {
+    return order;
+}
+
+// ========== Cycle ==========
+
+HTCycle::~HTCycle() {
+    reset();
+}
+
+bool HTCycle::active() const {
+    return !candidates.empty();
+}
+
+void HTCycle::collect(HTCycleScope scope) {
+    candidates.clear();
+    const PHLMONITOR cycle_monitor = monitor.lock();
+    if (cycle_monitor == nullptr)
+        return;
+
+    const PHLWINDOW focused = Desktop::focusState()->window();
+    const PHLWORKSPACE current_workspace = focused && focused->m_workspace ? focused->m_workspace
+                                                                           : cycle_monitor->m_activeWorkspace;
+    const int current_column = current_workspace ? name_to_column(current_workspace->m_name) : -1;
+
+    for (const PHLWINDOWREF& ref : ring.windows()) {
+        const PHLWINDOW window = ref.lock();
+        if (window == nullptr || !window->m_isMapped || window->isHidden() || window->m_workspace == nullptr
+            || window->m_workspace->m_isSpecialWorkspace)
+            continue;
+        if (scope == HTCycleScope::MONITOR && window->m_monitor != cycle_monitor)
+            continue;
+        if (scope == HTCycleScope::COLUMN && name_to_column(window->m_workspace->m_name) != current_column)
+            continue;
+        candidates.push_back(window);
+    }
+}
+
+void HTCycle::step(bool forward, HTCycleScope scope) {
+    if (!active()) {
+        monitor = Desktop::focusState()->monitor();
+        collect(scope);
+        if (candidates.empty())
+            return;
+
+        // the front of the ring is the window focused right now, the first step goes to the one before it
+        selected = 0;
+        captured.clear();
+    }
+
+    const size_t count = candidates.size();
+    selected = forward ? (selected + 1) % count : (selected + count - 1) % count;
+
+    // without a modifier held there is nothing to release, so the step is the whole switch
+    const SP<IKeyboard> keyboard = g_pSeatManager->m_keyboard.lock();
+    if (keyboard == nullptr
+        || !(keyboard->getModifiers() & (HL_MODIFIER_CTRL | HL_MODIFIER_ALT | HL_MODIFIER_META))) {
+        commit();
+        return;
+    }
+
+    schedule_capture();
+    damage();
+}
+
+void HTCycle::commit() {
+    if (!active())
+        return;
+
+    const PHLWINDOW window = candidates[selected].lock();
+    end();
+
+    // focuswindow also switches to the window's workspace, through hyprtile's own workspace hooks
+    if (window != nullptr && window != Desktop::focusState()->window())
+        HyprlandAPI::invokeHyprctlCommand(
+            "dispatch",
+            "focuswindow address:" + std::format("{:#x}", (uintptr_t)window.get())
+        );
+}
+
+void HTCycle::cancel() {
+    end();
+}
+
+void HTCycle::end() {
+    damage();
+
+    // Only keep the captures of the few windows a next cycle shows first, the rest are captured again on idle
+    constexpr size_t KEPT_PREVIEWS = 3;
+    std::unordered_map<const CWindow*, HTWindowCapture> kept;
+    for (const PHLWINDOWREF& ref : ring.windows()) {
+        if (kept.size() >= KEPT_PREVIEWS)
+            break;
+        const auto it = previews.find(ref.get());
+        if (it != previews.end())
+            kept.emplace(it->first, std::move(it->second));
+    }
+    previews = std::move(kept);
+
+    candidates.clear();
+    captured.clear();
+    selected = 0;
+    monitor.reset();
+}
+
+void HTCycle::reset() {
+    if (idle_source != nullptr) {
+        wl_event_source_remove(idle_source);
+        idle_source = nullptr;
+    }
+    candidates.clear();
+    captured.clear();
+    previews.clear();
+    selected = 0;
+    monitor.reset();
+    ring.clear();
+}
+
+bool HTCycle::on_key(const IKeyboard::SKeyEvent& event) {
+    if (!active())
+        return false;
+
+    if (event.state == WL_KEYBOARD_KEY_STATE_PRESSED && event.keycode == KEY_ESC) {
+        cancel();
+        return true;
+    }
+
+    // Releasing the modifier the cycle was opened with picks the selection, shift is left for stepping back
+    const bool modifier = event.keycode == KEY_LEFTALT || event.keycode == KEY_RIGHTALT
+        || event.keycode == KEY_LEFTMETA || event.keycode == KEY_RIGHTMETA || event.keycode == KEY_LEFTCTRL
+        || event.keycode == KEY_RIGHTCTRL;
+    if (event.state == WL_KEYBOARD_KEY_STATE_RELEASED && modifier)
+        commit();
+    return false;
+}
+
+void HTCycle::on_window_close(const PHLWINDOW& window) {
+    ring.remove(window);
+    previews.erase(window.get());
+    std::erase(captured, window.get());
+
+    if (!active())
+        return;
+
+    const auto it = std::ranges::find_if(candidates, [&window](const PHLWINDOWREF& ref) {
+        return ref.get() == window.get();
+    });
+    if (it == candidates.end())
+        return;
+
+    const size_t index = it - candidates.begin();
+    candidates.erase(it);
+    if (candidates.empty()) {
+        end();
+        return;
+    }
+    if (index < selected || selected >= candidates.size())
+        selected = selected == 0 ? 0 : selected - 1;
+    damage();
+}
+
+std::pair<size_t, size_t> HTCycle::visible_range() const {
+    const size_t max_items = std::max<Hyprlang::INT>(1, HTConfig::value<Hyprlang::INT>("cycle:max_items"));
+    const size_t count = std::min(max_items, candidates.size());
+    const size_t first = std::min(selected - std::min(selected, count / 2), candidates.size() - count);
+    return {first, first + count};
+}
+
+void HTCycle::schedule_capture() {
+    if (idle_source != nullptr)
+        return;
+
+    // Captures render the window in their own pass, so never from inside the frame that draws the overlay
+    idle_source = wl_event_loop_add_idle(
+        g_pCompositor->m_wlEventLoop,
+        [](void* data) {
+            HTCycle* cycle = (HTCycle*)data;
+            cycle->idle_source = nullptr;
+            cycle->capture_visible();
+        },
+        this
+    );
+}
+
+void HTCycle::capture_visible() {
+    if (!active())
+        return;
+
+    const PHLMONITOR cycle_monitor = monitor.lock();
+    if (cycle_monitor == nullptr)
+        return;
+
+    // Captured at the size of a slot, the overlay never draws them any bigger
+    const double slot_w = HTConfig::value<Hyprlang::FLOAT>("cycle:size");
+    const Vector2D slot_size = {slot_w, slot_w * cycle_monitor->m_size.y / cycle_monitor->m_size.x};
+
+    const auto [first, last] = visible_range();
+    bool any_captured = false;
+    for (size_t i = first; i < last; i++) {
+        const PHLWINDOW window = candidates[i].lock();
+        if (window == nullptr || std::ranges::contains(captured, window.get()))
+            continue;
+
+        captured.push_back(window.get());
+        any_captured = capture_window(window, previews[window.get()], slot_size) || any_captured;
+    }
+
+    if (any_captured)
+        damage();
+}
+
+void HTCycle::damage() const {
+    const PHLMONITOR cycle_monitor = monitor.lock();
+    if (cycle_monitor != nullptr)
+        g_pHyprRenderer->damageMonitor(cycle_monitor);
+}
+
+void HTCycle::render(const PHLMONITOR& render_monitor) {
+    if (!active() || render_monitor == nullptr || render_monitor != monitor.lock())
+        return;
+
+    static auto PACTIVECOL = CConfigValue<Hyprlang::CUSTOMTYPE>("general:col.active_border");
+    auto* const ACTIVECOL = (CGradientValueData*)(PACTIVECOL.ptr())->getData();
+    const float BORDERSIZE = HTConfig::value<Hyprlang::FLOAT>("border_size");
+    const float GAPSIZE = HTConfig::value<Hyprlang::FLOAT>("gap_size") * render_monitor->m_scale;
+
+    // Laid out in monitor local pixels like the overview's tiles: a row of slots centered on the monitor
+    const Vector2D monitor_size = render_monitor->m_transformedSize;
+    const auto [first, last] = visible_range();
+    const size_t count = last - first;
+    const double slot_w = std::min(
+        (double)HTConfig::value<Hyprlang::FLOAT>("cycle:size") * render_monitor->m_scale,
+        (monitor_size.x - GAPSIZE * (count + 1)) / count
+    );
+    const double slot_h = slot_w * monitor_size.y / monitor_size.x;
+    const CBox panel_box = {
+        (monitor_size.x - slot_w * count - GAPSIZE * (count + 1)) / 2,
+        (monitor_size.y - slot_h) / 2 - GAPSIZE,
+        slot_w * count + GAPSIZE * (count + 1),
+        slot_h + GAPSIZE * 2
+    };
+
+    CRectPassElement::SRectData panel;
+    panel.color = CHyprColor {HTConfig::value<Hyprlang::INT>("cycle:bg_color")};
+    panel.box = panel_box;
+    g_pHyprRenderer->m_renderPass.add(makeUnique<CRectPassElement>(panel));
+
+    for (size_t i = first; i < last; i++) {
+        const PHLWINDOW window = candidates[i].lock();
+        if (window == nullptr)
+            continue;
+
+        const CBox slot_box = {
+            panel_box.x + GAPSIZE + (slot_w + GAPSIZE) * (i - first),
+            panel_box.y + GAPSIZE,
+            slot_w,
+            slot_h
+        };
+
+        // the window fitted into its slot, keeping its aspect ratio
+        const Vector2D window_size = window->m_realSize->value();
+        const double fit = std::min(slot_w / std::max(1.0, window_size.x), slot_h / std::max(1.0, window_size.y));
+        const CBox window_box = {
+            slot_box.pos() + (slot_box.size() - window_size * fit) / 2,
+            window_size * fit
+        };
+
+        const auto preview = previews.find(window.get());
+        if (preview != previews.end() && preview->second.fb != nullptr) {
+            const CBox global_box = {
+                window_box.pos() / render_monitor->m_scale + render_monitor->m_position,
+                window_box.size() / render_monitor->m_scale
+            };
+            render_window_capture(preview->second, render_monitor, global_box);
+        } else {
+            // not captured yet, the next idle fills it in
+            CRectPassElement::SRectData placeholder;
+            placeholder.color = CHyprColor {1.0, 1.0, 1.0, 0.1};
+            placeholder.box = window_box;
+            g_pHyprRenderer->m_renderPass.add(makeUnique<CRectPassElement>(placeholder));
+        }
+
+        if (i == selected) {
+            CBorderPassElement::SBorderData border;
+            border.box = slot_box;
+            border.grad1 = *ACTIVECOL;
+            border.borderSize = BORDERSIZE;
+            g_pHyprRenderer->m_renderPass.add(makeUnique<CBorderPassElement>(border));
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <hyprland/src/devices/IKeyboard.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "render.hpp"
+
+struct wl_event_source;
+
+// Windows in most recently focused order. Focusing moves a window to the front and closing drops it, both O(1)
+class HTMruRing {
+  public:
+    void touch(const PHLWINDOW& window);
+    void remove(const PHLWINDOW& window);
+    void clear();
+
+    // Most recently focused first
+    const std::list<PHLWINDOWREF>& windows() const;
+
+  private:
+    std::list<PHLWINDOWREF> order;
+    std::unordered_map<const CWindow*, std::list<PHLWINDOWREF>::iterator> positions;
+};
+
+enum class HTCycleScope {
+    COLUMN,
+    MONITOR,
+    ALL,
+};
+
+// Alt-tab style switcher over the MRU ring. Stepping only moves the selection in an overlay, the selected
+// window is focused once the modifier holding the cycle open is released
+class HTCycle {
+  public:
+    HTCycle() = default;
+    ~HTCycle();
+
+    HTCycle(const HTCycle&) = delete;
+    HTCycle& operator=(const HTCycle&) = delete;
+
+    HTMruRing ring;
+
+    bool active() const;
+    // Starts a cycle on the focused monitor if none is running, then moves the selection
+    void step(bool forward, HTCycleScope scope);
+    void commit();
+    void cancel();
+    void reset();
+
+    // True if the key was consumed by the cycle
+    bool on_key(const IKeyboard::SKeyEvent& event);
+    void on_window_close(const PHLWINDOW& window);
+
+    // Draws the overlay if the cycle runs on monitor
+    void render(const PHLMONITOR& monitor);
+
+  private:
+    std::vector<PHLWINDOWREF> candidates;
+    size_t selected = 0;
+    PHLMONITORREF monitor;
+
+    // Captures of recently shown windows, kept between cycles so a new one draws instantly from the last ones
+    std::unordered_map<const CWindow*, HTWindowCapture> previews;
+    // Refreshed at most once per cycle
+    std::vector<const CWindow*> captured;
+    wl_event_source* idle_source = nullptr;
+
+    void collect(HTCycleScope scope);
+    // Range of candidates drawn in the overlay, around the selection
+    std::pair<size_t, size_t> visible_range() const;
+    void schedule_capture();
+    void capture_visible();
+    void end();
+    void damage() const;
+};
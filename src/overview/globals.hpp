@@ -19,6 +19,10 @@ inline CFunctionHook* should_render_window_hook = nullptr;
 inline CFunctionHook* is_solitary_blocked_hook = nullptr;
 typedef uint32_t (*origIsSolitaryBlocked)(void*, bool);
 inline void* render_window = nullptr;
+inline CFunctionHook* add_damage_box_hook = nullptr;
+inline CFunctionHook* add_damage_region_hook = nullptr;
+// Whether damage inside an open overview is widened to the whole monitor, without it the layouts redraw every frame
+inline bool damage_hooked = false;
 
 inline std::unique_ptr<HTManager> ht_manager;
 
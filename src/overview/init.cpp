@@ -1,4 +1,5 @@
 #include <linux/input-event-codes.h>
+#include <utility>
 
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/SharedDefs.hpp>
@@ -9,6 +10,7 @@
 #include <hyprland/src/managers/KeybindManager.hpp>
 #include <hyprland/src/layout/LayoutManager.hpp>
 #include <hyprland/src/managers/PointerManager.hpp>
+#include <hyprland/src/managers/SeatManager.hpp>
 #include <hyprland/src/managers/input/InputManager.hpp>
 #include <hyprland/src/plugins/HookSystem.hpp>
 #include <hyprland/src/plugins/PluginAPI.hpp>
@@ -16,12 +18,17 @@
 #include <hyprland/src/render/Renderer.hpp>
 #include <hyprland/src/event/EventBus.hpp>
 #include <hyprlang.hpp>
+#include <xkbcommon/xkbcommon.h>
 #include <hyprutils/math/Box.hpp>
 #include <hyprutils/math/Vector2D.hpp>
 
+#include "../replay.h"
+#include "../symbols.h"
+#include "../trace.h"
 #include "config.hpp"
 #include "globals.hpp"
 #include "overview.hpp"
+#include "render.hpp"
 #include "types.hpp"
 
 #include "init.hpp"
@@ -35,7 +42,7 @@ static SDispatchResult dispatch_if(std::string arg, bool is_active)
 {
     if (ht_manager == nullptr)
         return {.passEvent = true, .success = false, .error = "ht_manager is null"};
-    PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
     if (cursor_view == nullptr)
         return {.passEvent = true, .success = false, .error = "cursor_view is null"};
     if (cursor_view->active != is_active)
@@ -104,7 +111,7 @@ static SDispatchResult dispatch_move(std::string arg)
 {
     if (ht_manager == nullptr)
         return {.success = false, .error = "ht_manager is null"};
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
     if (cursor_view == nullptr)
         return {.success = false, .error = "cursor_view is null"};
     cursor_view->move(arg, false);
@@ -115,7 +122,7 @@ static SDispatchResult dispatch_move_window(std::string arg)
 {
     if (ht_manager == nullptr)
         return {.success = false, .error = "ht_manager is null"};
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
     if (cursor_view == nullptr)
         return {.success = false, .error = "cursor_view is null"};
     cursor_view->move(arg, true);
@@ -127,7 +134,7 @@ static SDispatchResult dispatch_kill_hover(std::string arg)
     if (ht_manager == nullptr)
         return {.success = false, .error = "ht_manager is null"};
 
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
     if (cursor_view == nullptr)
         return {.success = false, .error = "cursor_view is null"};
     // Only use actually hovered window when overview is active
@@ -139,25 +146,122 @@ static SDispatchResult dispatch_kill_hover(std::string arg)
     return {};
 }
 
+static SDispatchResult dispatch_cycle(std::string arg)
+{
+    if (ht_manager == nullptr)
+        return {.success = false, .error = "ht_manager is null"};
+    if (ht_manager->has_active_view())
+        return {.success = false, .error = "Cannot cycle while the overview is open"};
+
+    const auto space = arg.find_first_of(' ');
+    const std::string direction = arg.substr(0, space);
+    const std::string scope_arg = space == std::string::npos ? "" : arg.substr(space + 1);
+
+    if (direction != "next" && direction != "prev")
+        return {.success = false, .error = "Invalid cycle direction, expected next or prev"};
+
+    HTCycleScope scope;
+    if (scope_arg.empty() || scope_arg == "all")
+        scope = HTCycleScope::ALL;
+    else if (scope_arg == "column")
+        scope = HTCycleScope::COLUMN;
+    else if (scope_arg == "monitor")
+        scope = HTCycleScope::MONITOR;
+    else
+        return {.success = false, .error = "Invalid cycle scope, expected column, monitor or all"};
+
+    ht_manager->cycle.step(direction == "next", scope);
+    return {};
+}
+
 // ========== Overview Hooks ==========
 
 static void hook_render_workspace(void *thisptr, PHLMONITOR monitor, PHLWORKSPACE workspace, const Time::steady_tp &now,
                                   const CBox &geometry)
 {
+    HT_TRACE_SCOPE("hook_render_workspace", monitor ? monitor->m_id : -1);
+    replay::note_frame(monitor ? monitor->m_id : -1);
+
     if (ht_manager == nullptr)
     {
         ((render_workspace_t)(render_workspace_hook->m_original))(thisptr, monitor, workspace, now, geometry);
         return;
     }
-    const PHTVIEW view = ht_manager->get_view_from_monitor(monitor);
+    const PHTVIEW& view = ht_manager->get_view_from_monitor(monitor);
     if ((view != nullptr && view->navigating) || ht_manager->has_active_view())
     {
-        view->layout->render();
+        view->get_layout()->render();
     }
     else
     {
         ((render_workspace_t)(render_workspace_hook->m_original))(thisptr, monitor, workspace, now, geometry);
+        ht_manager->cycle.render(monitor);
+    }
+}
+
+// Clients report damage where their windows would be without the overview, which is somewhere else inside a tile.
+// While the overview shows a monitor, damage is kept where it was reported, for the overview's own damage and the
+// cursor, and also mapped into the tile of every window it touches. That is what wakes up an idle overview
+static HTLayoutBase *get_showing_layout(void *monitor)
+{
+    if (ht_manager == nullptr)
+        return nullptr;
+    const PHTVIEW &view = ht_manager->get_view_from_id(((CMonitor *)monitor)->m_id);
+    if (view == nullptr || !(view->active || view->navigating) || !view->has_layout())
+        return nullptr;
+    return view->get_layout().get();
+}
+
+// box is in the monitor's pixels, like CMonitor::addDamage takes it
+static void add_tile_damage(CMonitor *monitor, HTLayoutBase *layout, const CBox &box, CRegion &damage)
+{
+    const CBox logical_box = CBox {box}.scale(1.0 / monitor->m_scale);
+
+    for (const auto &window : g_pCompositor->m_windows)
+    {
+        if (!window->m_isMapped || window->m_workspace == nullptr ||
+            window->m_workspace->m_monitor.get() != monitor ||
+            !layout->overview_layout.contains(window->m_workspace->m_id))
+            continue;
+
+        const CBox window_box = window->getFullWindowBoundingBox().translate(-monitor->m_position);
+        const CBox damaged = window_box.intersection(logical_box);
+        if (damaged.empty())
+            continue;
+
+        const WORKSPACEID ws_id = window->m_workspace->m_id;
+        const Vector2D top_left = layout->local_ws_unscaled_to_global(damaged.pos(), ws_id);
+        const Vector2D bottom_right = layout->local_ws_unscaled_to_global(damaged.pos() + damaged.size(), ws_id);
+        CBox tile_box = {top_left, bottom_right - top_left};
+        // rounding of the scaled down box would otherwise leave the edge pixels stale
+        damage.add(tile_box.translate(-monitor->m_position).scale(monitor->m_scale).expand(1));
+    }
+}
+
+static bool hook_add_damage_box(void *thisptr, const CBox &box)
+{
+    HTLayoutBase *layout = get_showing_layout(thisptr);
+    if (layout == nullptr)
+        return ((add_damage_box_t)add_damage_box_hook->m_original)(thisptr, box);
+
+    CRegion damage {box};
+    add_tile_damage((CMonitor *)thisptr, layout, box, damage);
+    return ((add_damage_region_t)add_damage_region_hook->m_original)(thisptr, damage);
+}
+
+static bool hook_add_damage_region(void *thisptr, const CRegion &region)
+{
+    HTLayoutBase *layout = region.empty() ? nullptr : get_showing_layout(thisptr);
+    if (layout == nullptr)
+        return ((add_damage_region_t)add_damage_region_hook->m_original)(thisptr, region);
+
+    CRegion damage {region};
+    for (const auto &rect : region.getRects())
+    {
+        const CBox box = {(double)rect.x1, (double)rect.y1, (double)(rect.x2 - rect.x1), (double)(rect.y2 - rect.y1)};
+        add_tile_damage((CMonitor *)thisptr, layout, box, damage);
     }
+    return ((add_damage_region_t)add_damage_region_hook->m_original)(thisptr, damage);
 }
 
 static bool hook_should_render_window(void *thisptr, PHLWINDOW window, PHLMONITOR monitor)
@@ -165,15 +269,15 @@ static bool hook_should_render_window(void *thisptr, PHLWINDOW window, PHLMONITO
     bool ori_result = ((should_render_window_t)(should_render_window_hook->m_original))(thisptr, window, monitor);
     if (ht_manager == nullptr || !ht_manager->has_active_view())
         return ori_result;
-    const PHTVIEW view = ht_manager->get_view_from_monitor(monitor);
+    const PHTVIEW& view = ht_manager->get_view_from_monitor(monitor);
     if (view == nullptr)
         return ori_result;
-    return view->layout->should_render_window(window);
+    return view->get_layout()->should_render_window(window);
 }
 
 static uint32_t hook_is_solitary_blocked(void *thisptr, bool full)
 {
-    PHTVIEW view = ht_manager->get_view_from_cursor();
+    const PHTVIEW& view = ht_manager->get_view_from_cursor();
     if (view == nullptr)
     {
         Log::logger->log(Log::ERR, "[Hyprtile Overview] View is nullptr in hook_is_solitary_blocked");
@@ -196,7 +300,9 @@ static void on_mouse_button(IPointer::SButtonEvent e, Event::SCallbackInfo& info
     if (ht_manager == nullptr)
         return;
 
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
+    replay::record_input("button", {(double)e.button, (double)e.state});
+
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
     if (cursor_view == nullptr)
         return;
 
@@ -223,6 +329,7 @@ static void on_mouse_move(Vector2D c, Event::SCallbackInfo& info)
 {
     if (ht_manager == nullptr)
         return;
+    replay::record_input("move", {c.x, c.y});
     info.cancelled = ht_manager->on_mouse_move();
 }
 
@@ -230,13 +337,15 @@ static void on_mouse_axis(IPointer::SAxisEvent e, Event::SCallbackInfo& info)
 {
     if (ht_manager == nullptr)
         return;
-    info.cancelled = ht_manager->on_mouse_axis(e.delta);
+    replay::record_input("axis", {(double)e.axis, e.delta, (double)e.source});
+    info.cancelled = ht_manager->on_mouse_axis(e);
 }
 
 static void on_swipe_begin(IPointer::SSwipeBeginEvent e, Event::SCallbackInfo& info)
 {
     if (ht_manager == nullptr)
         return;
+    replay::record_input("swipe_begin", {(double)e.fingers});
     ht_manager->swipe_start();
 }
 
@@ -244,6 +353,7 @@ static void on_swipe_update(IPointer::SSwipeUpdateEvent e, Event::SCallbackInfo&
 {
     if (ht_manager == nullptr)
         return;
+    replay::record_input("swipe_update", {(double)e.fingers, e.delta.x, e.delta.y});
     info.cancelled = ht_manager->swipe_update(e);
 }
 
@@ -251,14 +361,32 @@ static void on_swipe_end(IPointer::SSwipeEndEvent e, Event::SCallbackInfo& info)
 {
     if (ht_manager == nullptr)
         return;
-    info.cancelled = ht_manager->swipe_end();
+    replay::record_input("swipe_end", {(double)e.cancelled});
+    info.cancelled = ht_manager->swipe_end(e.timeMs);
 }
 
-static void cancel_event(Event::SCallbackInfo& info)
+static void on_touch_down(ITouch::SDownEvent e, Event::SCallbackInfo& info)
 {
-    if (ht_manager == nullptr || !ht_manager->cursor_view_active())
+    if (ht_manager == nullptr)
         return;
-    info.cancelled = true;
+    replay::record_input("touch_down", {(double)e.touchID, e.pos.x, e.pos.y});
+    info.cancelled = ht_manager->touch_down(e);
+}
+
+static void on_touch_up(ITouch::SUpEvent e, Event::SCallbackInfo& info)
+{
+    if (ht_manager == nullptr)
+        return;
+    replay::record_input("touch_up", {(double)e.touchID});
+    info.cancelled = ht_manager->touch_up(e);
+}
+
+static void on_touch_motion(ITouch::SMotionEvent e, Event::SCallbackInfo& info)
+{
+    if (ht_manager == nullptr)
+        return;
+    replay::record_input("touch_motion", {(double)e.touchID, e.pos.x, e.pos.y});
+    info.cancelled = ht_manager->touch_motion(e);
 }
 
 static void on_key_press(IKeyboard::SKeyEvent event, Event::SCallbackInfo &info)
@@ -266,6 +394,16 @@ static void on_key_press(IKeyboard::SKeyEvent event, Event::SCallbackInfo &info)
     if (ht_manager == nullptr)
         return;
 
+    // Only keys the overview or the cycle act on, anything typed into windows stays out of the log
+    if (ht_manager->cycle.active() || ht_manager->has_active_view())
+        replay::record_input("key", {(double)event.keycode, (double)event.state});
+
+    if (ht_manager->cycle.active())
+    {
+        info.cancelled = ht_manager->cycle.on_key(event);
+        return;
+    }
+
     // Check if any view is active
     if (!ht_manager->has_active_view())
         return;
@@ -274,12 +412,51 @@ static void on_key_press(IKeyboard::SKeyEvent event, Event::SCallbackInfo &info)
     if (event.state != WL_KEYBOARD_KEY_STATE_PRESSED)
         return;
 
+    // Escape drops an active filter first, a second press closes the overview
+    if (event.keycode == KEY_ESC && ht_manager->filter_active())
+    {
+        ht_manager->set_filter("");
+        info.cancelled = true;
+        return;
+    }
+
     // Check for Escape key and Enter key
     if (event.keycode == KEY_ESC || event.keycode == KEY_ENTER)
     {
         ht_manager->hide_all_views();
         info.cancelled = true;
+        return;
     }
+
+    if (!HTConfig::value<Hyprlang::INT>("type_to_filter"))
+        return;
+
+    if (event.keycode == KEY_BACKSPACE)
+    {
+        std::string query = ht_manager->filter_query;
+        // drop the last UTF-8 character, not just its last byte
+        while (!query.empty() && ((unsigned char)query.back() & 0xC0) == 0x80)
+            query.pop_back();
+        if (!query.empty())
+            query.pop_back();
+        ht_manager->set_filter(query);
+        info.cancelled = true;
+        return;
+    }
+
+    // Leave anything with a modifier other than shift to the keybinds
+    const SP<IKeyboard> keyboard = g_pSeatManager->m_keyboard.lock();
+    if (keyboard == nullptr || keyboard->m_xkbState == nullptr ||
+        (keyboard->getModifiers() & (HL_MODIFIER_CTRL | HL_MODIFIER_ALT | HL_MODIFIER_META)))
+        return;
+
+    char text[16] = {};
+    const int len = xkb_state_key_get_utf8(keyboard->m_xkbState, event.keycode + 8, text, sizeof(text));
+    if (len <= 0 || (unsigned char)text[0] < 0x20 || text[0] == 0x7F)
+        return;
+
+    ht_manager->set_filter(ht_manager->filter_query + std::string(text, len));
+    info.cancelled = true;
 }
 
 // ========== Monitor Registration ==========
@@ -290,14 +467,21 @@ static void register_monitors()
         return;
     for (const PHLMONITOR &monitor : g_pCompositor->m_monitors)
     {
-        const PHTVIEW view = ht_manager->get_view_from_monitor(monitor);
+        const PHTVIEW& view = ht_manager->get_view_from_monitor(monitor);
         if (view != nullptr)
         {
-            if (!view->active)
-                view->layout->init_position();
+            if (!view->active && view->has_layout())
+                view->get_layout()->init_position();
+            continue;
+        }
+        if (const PHTVIEW cached = ht_manager->take_detached_view(monitor); cached != nullptr)
+        {
+            ht_manager->add_view(cached);
+            Log::logger->log(LOG, "[Hyprtile Overview] Reattaching view for re-plugged monitor {}",
+                             monitor->m_description);
             continue;
         }
-        ht_manager->views.push_back(makeShared<HTView>(monitor->m_id));
+        ht_manager->add_view(makeShared<HTView>(monitor->m_id));
 
         Log::logger->log(
             LOG,
@@ -309,23 +493,49 @@ static void register_monitors()
     }
 }
 
+static HTConfig::Snapshot config_snapshot;
+
 static void on_config_reloaded()
 {
     if (ht_manager == nullptr)
         return;
 
-    // re-init scale and offset for inactive views, change layout if changed
-    for (PHTVIEW &view : ht_manager->views)
+    // Reloads come often from scripts (theme switches), only redo what the new config actually changed
+    const HTConfig::Snapshot previous = std::exchange(config_snapshot, HTConfig::snapshot());
+    const bool geometry_changed = config_snapshot.geometry != previous.geometry;
+    const bool colours_changed = config_snapshot.colours != previous.colours;
+
+    for (const PHTVIEW &view : ht_manager->views)
     {
-        if (view == nullptr)
+        // Views that were never opened build their layout from the current config when they are
+        if (!view->has_layout())
             continue;
-        const Hyprlang::STRING new_layout = HTConfig::value<Hyprlang::STRING>("layout");
-        if (HTConfig::value<Hyprlang::INT>("close_overview_on_reload") || view->layout->layout_name() != new_layout)
+
+        // Only a different layout type needs a new layout object
+        if (view->get_layout()->layout_name() != config_snapshot.layout)
+        {
+            Log::logger->log(LOG, "[Hyprtile Overview] Layout changed on config reload, closing overview");
+            if (view->active)
+                view->hide(false);
+            view->change_layout(config_snapshot.layout);
+            continue;
+        }
+
+        if (view->active && HTConfig::value<Hyprlang::INT>("close_overview_on_reload"))
         {
             Log::logger->log(LOG, "[Hyprtile Overview] Closing overview on config reload");
             view->hide(false);
-            view->change_layout(new_layout);
+            continue;
         }
+
+        if (geometry_changed)
+        {
+            view->get_layout()->on_geometry_changed(view->active);
+            if (view->active && view->get_monitor() != nullptr)
+                g_pHyprRenderer->damageMonitor(view->get_monitor());
+        }
+        else if (colours_changed && (view->active || view->navigating) && view->get_monitor() != nullptr)
+            g_pHyprRenderer->damageMonitor(view->get_monitor());
     }
 }
 
@@ -335,47 +545,59 @@ static void init_functions()
 {
     bool success = true;
 
-    static auto FNS1 = HyprlandAPI::findFunctionsByName(PHANDLE, "renderWorkspace");
-    if (FNS1.empty())
+    static const auto FNS1 = symbols::find("renderWorkspace");
+    if (FNS1.address == nullptr)
         fail_exit("No renderWorkspace!");
-    render_workspace_hook = HyprlandAPI::createFunctionHook(PHANDLE, FNS1[0].address, (void *)hook_render_workspace);
-    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS1[0].signature);
+    render_workspace_hook = HyprlandAPI::createFunctionHook(PHANDLE, FNS1.address, (void *)hook_render_workspace);
+    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS1.signature);
     success = render_workspace_hook->hook();
 
-    static auto FNS2 = HyprlandAPI::findFunctionsByName(
-        PHANDLE,
+    static const auto FNS2 = symbols::find(
         "_ZN13CHyprRenderer18shouldRenderWindowEN9Hyprutils6Memory14CS"
         "haredPointerIN7Desktop4View7CWindowEEENS2_I8CMonitorEE"
     );
-    if (FNS2.empty())
+    if (FNS2.address == nullptr)
         fail_exit("No shouldRenderWindow");
     should_render_window_hook =
-        HyprlandAPI::createFunctionHook(PHANDLE, FNS2[0].address, (void *)hook_should_render_window);
-    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS2[0].signature);
+        HyprlandAPI::createFunctionHook(PHANDLE, FNS2.address, (void *)hook_should_render_window);
+    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS2.signature);
     success = should_render_window_hook->hook() && success;
 
-    static auto FNS3 = HyprlandAPI::findFunctionsByName(
-        PHANDLE,
+    static const auto FNS3 = symbols::find(
         "_ZN13CHyprRenderer12renderWindowEN9Hyprutils6Memory14CSha"
         "redPointerIN7Desktop4View7CWindowEEENS2_I8CMonitorEERKNSt"
         "6chrono10time_pointINS9_3_V212steady_clockENS9_8durationI"
         "lSt5ratioILl1ELl1000000000EEEEEEb15eRenderPassModebb"
     );
-    if (FNS3.empty())
+    if (FNS3.address == nullptr)
         fail_exit("No renderWindow");
-    render_window = FNS3[0].address;
+    render_window = FNS3.address;
 
-    static auto FNS4 = HyprlandAPI::findFunctionsByName(PHANDLE, "isSolitaryBlocked");
-    if (FNS4.empty())
+    static const auto FNS4 = symbols::find("isSolitaryBlocked");
+    if (FNS4.address == nullptr)
         fail_exit("No isSolitaryBlocked");
 
     is_solitary_blocked_hook =
-        HyprlandAPI::createFunctionHook(PHANDLE, FNS4[0].address, (void *)hook_is_solitary_blocked);
-    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS4[0].signature);
+        HyprlandAPI::createFunctionHook(PHANDLE, FNS4.address, (void *)hook_is_solitary_blocked);
+    Log::logger->log(LOG, "[Hyprtile Overview] Attempting hook {}", FNS4.signature);
     success = is_solitary_blocked_hook->hook() && success;
 
     if (!success)
         fail_exit("Failed initializing hooks");
+
+    // Optional: without them the layouts keep redrawing every frame while the overview is open
+    static const auto FNS5 = symbols::find("_ZN8CMonitor9addDamageERKN9Hyprutils4Math4CBoxE");
+    static const auto FNS6 = symbols::find("_ZN8CMonitor9addDamageERKN9Hyprutils4Math7CRegionE");
+    if (FNS5.address != nullptr && FNS6.address != nullptr)
+    {
+        add_damage_box_hook = HyprlandAPI::createFunctionHook(PHANDLE, FNS5.address, (void *)hook_add_damage_box);
+        add_damage_region_hook =
+            HyprlandAPI::createFunctionHook(PHANDLE, FNS6.address, (void *)hook_add_damage_region);
+        damage_hooked = add_damage_box_hook->hook() && add_damage_region_hook->hook();
+    }
+    if (!damage_hooked)
+        Log::logger->log(Log::WARN,
+                         "[Hyprtile Overview] No CMonitor::addDamage hooks, the overview redraws every frame");
 }
 
 static void register_callbacks()
@@ -387,10 +609,9 @@ static void register_callbacks()
         bus.input.mouse.move.listen(on_mouse_move),
         bus.input.mouse.axis.listen(on_mouse_axis),
 
-    	// TODO: support touch
-        bus.input.touch.down.listen([](ITouch::SDownEvent e, Event::SCallbackInfo &i) { cancel_event(i); }),
-        bus.input.touch.up.listen([](ITouch::SUpEvent e, Event::SCallbackInfo &i) { cancel_event(i); }),
-        bus.input.touch.motion.listen([](ITouch::SMotionEvent e, Event::SCallbackInfo &i) { cancel_event(i); }),
+        bus.input.touch.down.listen(on_touch_down),
+        bus.input.touch.up.listen(on_touch_up),
+        bus.input.touch.motion.listen(on_touch_motion),
 
         bus.gesture.swipe.begin.listen(on_swipe_begin),
         bus.gesture.swipe.update.listen(on_swipe_update),
@@ -398,26 +619,121 @@ static void register_callbacks()
 
         bus.config.reloaded.listen(on_config_reloaded),
         bus.monitor.added.listen([](PHLMONITOR m) { register_monitors(); }),
+        bus.monitor.removed.listen([](PHLMONITOR m) {
+            if (ht_manager != nullptr)
+                ht_manager->remove_monitor(m);
+        }),
 
         bus.input.keyboard.key.listen(on_key_press),
+
+        bus.window.open.listen([](PHLWINDOW window) {
+            if (ht_manager != nullptr)
+                ht_manager->search_index.update(window);
+        }),
+        bus.window.title.listen([](PHLWINDOW window) {
+            if (ht_manager != nullptr)
+                ht_manager->search_index.update(window);
+        }),
+        bus.window.close.listen([](PHLWINDOW window) {
+            if (ht_manager == nullptr)
+                return;
+            ht_manager->search_index.remove(window);
+            ht_manager->cycle.on_window_close(window);
+        }),
+        bus.window.active.listen([](PHLWINDOW window, auto&&...) {
+            if (ht_manager != nullptr)
+                ht_manager->cycle.ring.touch(window);
+        }),
     };
+
+    // windows that were open before the plugin was loaded
+    for (const auto& window : g_pCompositor->m_windows)
+    {
+        if (window->m_isMapped)
+        {
+            ht_manager->search_index.update(window);
+            ht_manager->cycle.ring.touch(window);
+        }
+    }
+    // their focus order is unknown, at least the focused one goes first
+    ht_manager->cycle.ring.touch(Desktop::focusState()->window());
+
+    // Recorded input is fed back through the same callbacks, with the time of the replay
+    const auto now_ms = [] { return (uint32_t)(trace::now_ns() / 1'000'000); };
+    replay::add_input("move", [](const std::vector<double>& v) {
+        g_pPointerManager->warpTo({v.at(0), v.at(1)});
+        Event::SCallbackInfo info;
+        on_mouse_move({v.at(0), v.at(1)}, info);
+    });
+    replay::add_input("button", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_mouse_button(
+            {.timeMs = now_ms(), .button = (uint32_t)v.at(0), .state = (wl_pointer_button_state)v.at(1)},
+            info
+        );
+    });
+    replay::add_input("axis", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_mouse_axis(
+            {.timeMs = now_ms(),
+             .axis = (wl_pointer_axis)v.at(0),
+             .source = (wl_pointer_axis_source)v.at(2),
+             .delta = v.at(1)},
+            info
+        );
+    });
+    replay::add_input("swipe_begin", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_swipe_begin({.timeMs = now_ms(), .fingers = (uint32_t)v.at(0)}, info);
+    });
+    replay::add_input("swipe_update", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_swipe_update({.timeMs = now_ms(), .fingers = (uint32_t)v.at(0), .delta = {v.at(1), v.at(2)}}, info);
+    });
+    replay::add_input("swipe_end", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_swipe_end({.timeMs = now_ms(), .cancelled = v.at(0) != 0}, info);
+    });
+    replay::add_input("touch_down", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_touch_down({.timeMs = now_ms(), .touchID = (int32_t)v.at(0), .pos = {v.at(1), v.at(2)}}, info);
+    });
+    replay::add_input("touch_up", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_touch_up({.timeMs = now_ms(), .touchID = (int32_t)v.at(0)}, info);
+    });
+    replay::add_input("touch_motion", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_touch_motion({.timeMs = now_ms(), .touchID = (int32_t)v.at(0), .pos = {v.at(1), v.at(2)}}, info);
+    });
+    // typed filter text comes from the keymap state at replay time, like it would for a live key press
+    replay::add_input("key", [now_ms](const std::vector<double>& v) {
+        Event::SCallbackInfo info;
+        on_key_press(
+            {.timeMs = now_ms(), .keycode = (uint32_t)v.at(0), .state = (wl_keyboard_key_state)v.at(1)},
+            info
+        );
+    });
 }
 
 static void add_dispatchers()
 {
     // Main expo toggle dispatcher
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo", dispatch_toggle_view);
+    replay::add_dispatcher("hyprtile:expo", dispatch_toggle_view);
 
     // Conditional dispatchers
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo:if_not_active", dispatch_if_not_active);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo:if_active", dispatch_if_active);
+    replay::add_dispatcher("hyprtile:expo:if_not_active", dispatch_if_not_active);
+    replay::add_dispatcher("hyprtile:expo:if_active", dispatch_if_active);
 
     // Navigation dispatchers
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo:move", dispatch_move);
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo:movewindow", dispatch_move_window);
+    replay::add_dispatcher("hyprtile:expo:move", dispatch_move);
+    replay::add_dispatcher("hyprtile:expo:movewindow", dispatch_move_window);
 
     // Utility dispatchers
-    HyprlandAPI::addDispatcherV2(PHANDLE, "hyprtile:expo:killhovered", dispatch_kill_hover);
+    replay::add_dispatcher("hyprtile:expo:killhovered", dispatch_kill_hover);
+
+    // MRU window switcher, works without the overview open
+    replay::add_dispatcher("hyprtile:cycle", dispatch_cycle);
 }
 
 static void init_config()
@@ -433,7 +749,17 @@ static void init_config()
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:focus_scale", Hyprlang::FLOAT{1.1f});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:exit_on_hovered", Hyprlang::INT{0});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:warp_on_move_window", Hyprlang::INT{1});
-    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:close_overview_on_reload", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:close_overview_on_reload", Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:scroll_speed", Hyprlang::FLOAT{1.f});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:prefetch", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:prefetch_max_age", Hyprlang::INT{1000});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:type_to_filter", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:filter_dim", Hyprlang::FLOAT{0.6f});
+
+    // MRU switcher
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:cycle:max_items", Hyprlang::INT{8});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:cycle:size", Hyprlang::FLOAT{240.f});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:cycle:bg_color", Hyprlang::INT{0xaa000000});
 
     // Mouse buttons
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:drag_button", Hyprlang::INT{BTN_LEFT});
@@ -443,10 +769,19 @@ static void init_config()
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:enabled", Hyprlang::INT{1});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:move_fingers", Hyprlang::INT{3});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:move_distance", Hyprlang::FLOAT{300.0});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:move_flick_time", Hyprlang::FLOAT{150.0});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:open_fingers", Hyprlang::INT{4});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:open_distance", Hyprlang::FLOAT{300.0});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:gestures:open_positive", Hyprlang::INT{1});
 
+    // Touch settings
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:touch:enabled", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:touch:long_press_ms", Hyprlang::INT{400});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:touch:tap_distance", Hyprlang::FLOAT{10.0});
+
+    // Column layout specific
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:column:min_tile_width", Hyprlang::FLOAT{0.f});
+
     // Grid layout specific (kept for compatibility)
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:grid:rows", Hyprlang::INT{3});
     HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:expo:grid:cols", Hyprlang::INT{3});
@@ -488,6 +823,7 @@ void exit()
 
     if (ht_manager)
         ht_manager->reset();
+    end_drag_preview();
 
     Log::logger->log(LOG, "[Hyprtile Overview] Overview module cleaned up");
 }
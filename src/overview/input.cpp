@@ -1,24 +1,32 @@
 #include <linux/input-event-codes.h>
 
+#include <algorithm>
+
 #include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/state/FocusState.hpp>
 #include <hyprland/src/macros.hpp>
 #include <hyprland/src/managers/KeybindManager.hpp>
 #include <hyprland/src/layout/LayoutManager.hpp>
 #include <hyprland/src/managers/PointerManager.hpp>
 #include <hyprland/src/managers/input/InputManager.hpp>
+#include <hyprland/src/render/Renderer.hpp>
 
+#include "../trace.h"
 #include "config.hpp"
 #include "manager.hpp"
 #include "overview.hpp"
+#include "render.hpp"
 
 bool HTManager::start_window_drag()
 {
+    HT_TRACE_SCOPE("start_window_drag");
+
     const PHLMONITOR cursor_monitor = g_pCompositor->getMonitorFromCursor();
-    const PHTVIEW cursor_view = get_view_from_monitor(cursor_monitor);
+    const PHTVIEW& cursor_view = get_view_from_monitor(cursor_monitor);
     if (cursor_monitor == nullptr || cursor_view == nullptr || !cursor_view->active || cursor_view->closing)
         return false;
 
-    if (!cursor_view->layout->should_manage_mouse())
+    if (!cursor_view->get_layout()->should_manage_mouse())
     {
         // hide all views if should not manage mouse but active
         hide_all_views();
@@ -26,7 +34,7 @@ bool HTManager::start_window_drag()
     }
 
     const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
-    const WORKSPACEID workspace_id = cursor_view->layout->get_ws_id_from_global(mouse_coords);
+    const WORKSPACEID workspace_id = cursor_view->get_layout()->get_ws_id_from_global(mouse_coords);
     PHLWORKSPACE cursor_workspace = g_pCompositor->getWorkspaceByID(workspace_id);
 
     // If left click on non-workspace workspace, do nothing
@@ -37,7 +45,7 @@ bool HTManager::start_window_drag()
     cursor_monitor->changeWorkspace(cursor_workspace, true);
 
     const Vector2D workspace_coords =
-        cursor_view->layout->global_to_local_ws_unscaled(mouse_coords, workspace_id) + cursor_monitor->m_position;
+        cursor_view->get_layout()->global_to_local_ws_unscaled(mouse_coords, workspace_id) + cursor_monitor->m_position;
 
     g_pPointerManager->warpTo(workspace_coords);
     g_pKeybindManager->changeMouseBindMode(MBIND_MOVE);
@@ -50,15 +58,17 @@ bool HTManager::start_window_drag()
     const PHLWINDOW dragged_window = target->window();
     if (dragged_window != nullptr)
     {
+        begin_drag_preview(dragged_window);
+
         if (g_layoutManager->dragController()->draggingTiled()) {
-            const Vector2D pre_pos = cursor_view->layout->local_ws_unscaled_to_global(
+            const Vector2D pre_pos = cursor_view->get_layout()->local_ws_unscaled_to_global(
                 dragged_window->m_realPosition->value() - dragged_window->m_monitor->m_position, workspace_id);
-            const Vector2D post_pos = cursor_view->layout->local_ws_unscaled_to_global(
+            const Vector2D post_pos = cursor_view->get_layout()->local_ws_unscaled_to_global(
                 dragged_window->m_realPosition->goal() - dragged_window->m_monitor->m_position, workspace_id);
             const Vector2D mapped_pre_pos =
-                (pre_pos - mouse_coords) / cursor_view->layout->drag_window_scale() + mouse_coords;
+                (pre_pos - mouse_coords) / cursor_view->get_layout()->drag_window_scale() + mouse_coords;
             const Vector2D mapped_post_pos =
-                (post_pos - mouse_coords) / cursor_view->layout->drag_window_scale() + mouse_coords;
+                (post_pos - mouse_coords) / cursor_view->get_layout()->drag_window_scale() + mouse_coords;
 
             dragged_window->m_realPosition->setValueAndWarp(mapped_pre_pos);
             *dragged_window->m_realPosition = mapped_post_pos;
@@ -77,8 +87,12 @@ bool HTManager::start_window_drag()
 
 bool HTManager::end_window_drag()
 {
+    HT_TRACE_SCOPE("end_window_drag");
+
+    end_drag_preview();
+
     const PHLMONITOR cursor_monitor = g_pCompositor->getMonitorFromCursor();
-    const PHTVIEW cursor_view = get_view_from_monitor(cursor_monitor);
+    const PHTVIEW& cursor_view = get_view_from_monitor(cursor_monitor);
     if (cursor_monitor == nullptr || cursor_view == nullptr)
     {
         g_pKeybindManager->changeMouseBindMode(MBIND_INVALID);
@@ -93,7 +107,7 @@ bool HTManager::end_window_drag()
     }
 
     // For linear layout: if dropping on big workspace, just pass on
-    if (!cursor_view->layout->should_manage_mouse())
+    if (!cursor_view->get_layout()->should_manage_mouse())
     {
         g_pKeybindManager->changeMouseBindMode(MBIND_INVALID);
         return false;
@@ -114,9 +128,14 @@ bool HTManager::end_window_drag()
 
     const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
     Vector2D use_mouse_coords = mouse_coords;
-    const WORKSPACEID workspace_id = cursor_view->layout->get_ws_id_from_global(mouse_coords);
+    const WORKSPACEID workspace_id = cursor_view->get_layout()->get_ws_id_from_global(mouse_coords);
     PHLWORKSPACE cursor_workspace = g_pCompositor->getWorkspaceByID(workspace_id);
 
+    // The drop lands on whichever open overview is under the cursor, which need not be the one the drag started
+    // on. Only a drop between tiles goes back to the window's own workspace, in the view that owns it
+    PHLMONITOR drop_monitor = cursor_monitor;
+    PHTVIEW drop_view = cursor_view;
+
     // Release on empty dummy workspace, so create and switch to it
     if (cursor_workspace == nullptr && workspace_id != WORKSPACE_INVALID)
     {
@@ -125,9 +144,19 @@ bool HTManager::end_window_drag()
     else if (workspace_id == WORKSPACE_INVALID)
     {
         cursor_workspace = dragged_window->m_workspace;
+
+        const PHTVIEW& home_view = get_view_from_monitor(cursor_workspace ? cursor_workspace->m_monitor.lock() : nullptr);
+        if (home_view == nullptr || !home_view->active || home_view->closing)
+        {
+            g_pKeybindManager->changeMouseBindMode(MBIND_INVALID);
+            return false;
+        }
+        drop_view = home_view;
+        drop_monitor = home_view->get_monitor();
+
         // Ensure that the mouse coords are snapped to inside the workspace box itself
         use_mouse_coords =
-            cursor_view->layout->get_global_ws_box(cursor_workspace->m_id).closestPoint(use_mouse_coords);
+            drop_view->get_layout()->get_global_ws_box(cursor_workspace->m_id).closestPoint(use_mouse_coords);
 
         Log::logger->log(
             LOG,
@@ -145,21 +174,22 @@ bool HTManager::end_window_drag()
 
     Log::logger->log(LOG, "[Hyprtile Overview] trying to drop window on ws {}", cursor_workspace->m_id);
 
-    // PHLWORKSPACEREF o_workspace = cursor_monitor->m_activeWorkspace;
-    cursor_monitor->changeWorkspace(cursor_workspace, true);
+    // PHLWORKSPACEREF o_workspace = drop_monitor->m_activeWorkspace;
+    drop_monitor->changeWorkspace(cursor_workspace, true);
 
+    // Moves across monitors too, in one step
     g_pCompositor->moveWindowToWorkspaceSafe(dragged_window, cursor_workspace);
 
     const Vector2D workspace_coords =
-        cursor_view->layout->global_to_local_ws_unscaled(use_mouse_coords, cursor_workspace->m_id) +
-        cursor_monitor->m_position;
+        drop_view->get_layout()->global_to_local_ws_unscaled(use_mouse_coords, cursor_workspace->m_id) +
+        drop_monitor->m_position;
 
     const Vector2D tp_pos =
-        cursor_view->layout->global_to_local_ws_unscaled((dragged_window->m_realPosition->value() - use_mouse_coords) *
-                                                                 cursor_view->layout->drag_window_scale() +
-                                                             use_mouse_coords,
-                                                         cursor_workspace->m_id) +
-        cursor_monitor->m_position;
+        drop_view->get_layout()->global_to_local_ws_unscaled((dragged_window->m_realPosition->value() - use_mouse_coords) *
+                                                               drop_view->get_layout()->drag_window_scale() +
+                                                           use_mouse_coords,
+                                                       cursor_workspace->m_id) +
+        drop_monitor->m_position;
     dragged_window->m_realPosition->setValueAndWarp(tp_pos);
 
     g_pPointerManager->warpTo(workspace_coords);
@@ -172,7 +202,7 @@ bool HTManager::end_window_drag()
     dragged_window->m_movingFromWorkspaceAlpha->setValueAndWarp(1.0);
 
     // if (o_workspace != nullptr)
-    //     cursor_monitor->changeWorkspace(o_workspace.lock(), true);
+    //     drop_monitor->changeWorkspace(o_workspace.lock(), true);
 
     // Do not return true and cancel the event! Mouse release requires some stuff to be done for
     // floating windows to be unfocused properly
@@ -181,19 +211,15 @@ bool HTManager::end_window_drag()
 
 bool HTManager::exit_to_workspace()
 {
-    const PHTVIEW cursor_view = get_view_from_cursor();
+    const PHTVIEW& cursor_view = get_view_from_cursor();
     if (cursor_view == nullptr)
         return false;
 
-    if (!cursor_view->active || !cursor_view->layout->should_manage_mouse())
+    if (!cursor_view->active || !cursor_view->get_layout()->should_manage_mouse())
         return false;
 
-    for (PHTVIEW view : views)
-    {
-        if (view == nullptr)
-            continue;
+    for (const PHTVIEW &view : views)
         view->hide(true);
-    }
     return true;
 }
 
@@ -202,25 +228,40 @@ bool HTManager::on_mouse_move()
     return false;
 }
 
-bool HTManager::on_mouse_axis(double delta)
+bool HTManager::on_mouse_axis(const IPointer::SAxisEvent& e)
 {
-    const PHTVIEW cursor_view = get_view_from_cursor();
-    if (cursor_view == nullptr)
+    const PHTVIEW& cursor_view = get_view_from_cursor();
+    if (cursor_view == nullptr || !cursor_view->active || cursor_view->closing)
+        return false;
+
+    const HTAxisEvent axis_event{
+        .delta = e.axis == WL_POINTER_AXIS_HORIZONTAL_SCROLL ? Vector2D{e.delta, 0} : Vector2D{0, e.delta},
+        .continuous = e.source == WL_POINTER_AXIS_SOURCE_FINGER || e.source == WL_POINTER_AXIS_SOURCE_CONTINUOUS,
+        .time_ms = e.timeMs,
+    };
+
+    if (!cursor_view->get_layout()->on_mouse_axis(axis_event))
         return false;
 
-    return cursor_view->layout->on_mouse_axis(delta);
+    g_pHyprRenderer->damageMonitor(cursor_view->get_monitor());
+    return true;
 }
 
 void HTManager::swipe_start()
 {
     swipe_state = HT_SWIPE_NONE;
     swipe_amt = 0.0;
+    swipe_axis = 0;
+    swipe_velocity = {};
+    swipe_last_ms = 0;
 }
 
 bool HTManager::swipe_update(IPointer::SSwipeUpdateEvent e)
 {
+    HT_TRACE_SCOPE("swipe_update");
+
     const PHLMONITOR cursor_monitor = g_pCompositor->getMonitorFromCursor();
-    const PHTVIEW cursor_view = get_view_from_monitor(cursor_monitor);
+    const PHTVIEW& cursor_view = get_view_from_monitor(cursor_monitor);
     if (cursor_view == nullptr)
         return false;
 
@@ -275,7 +316,7 @@ bool HTManager::swipe_update(IPointer::SSwipeUpdateEvent e)
         {
             swipe_amt += deltaY;
             const float swipe_perc = 1.0 - std::clamp(swipe_amt / OPEN_DISTANCE, 0.01f, 1.0f);
-            cursor_view->layout->close_open_lerp(swipe_perc);
+            cursor_view->get_layout()->close_open_lerp(swipe_perc);
         }
     }
     else if (e.fingers == MOVE_FINGERS)
@@ -292,25 +333,38 @@ bool HTManager::swipe_update(IPointer::SSwipeUpdateEvent e)
             else
             {
                 swipe_state = HT_SWIPE_MOVE;
+                swipe_axis = std::abs(e.delta.x) >= std::abs(e.delta.y) ? 'h' : 'v';
+                swipe_velocity = {};
+                swipe_last_ms = e.timeMs;
                 cursor_view->navigating = true;
-
-                // need to schedule frames for monitor, otherwise the screen doesn't re-render
-                g_pHyprRenderer->damageMonitor(cursor_monitor);
-                g_pCompositor->scheduleFrameForMonitor(cursor_monitor);
+                cursor_view->get_layout()->on_move_swipe_begin();
             }
         }
 
         if (swipe_state == HT_SWIPE_MOVE)
         {
-            cursor_view->layout->on_move_swipe(e.delta);
+            const Vector2D delta = swipe_axis == 'h' ? Vector2D{e.delta.x, 0} : Vector2D{0, e.delta.y};
+
+            // Smooth over the last few events so a single jittery one at lift-off doesn't decide the flick
+            const uint32_t elapsed_ms = e.timeMs - swipe_last_ms;
+            if (elapsed_ms > 0)
+            {
+                swipe_velocity = swipe_velocity * 0.5 + delta / elapsed_ms * 0.5;
+                swipe_last_ms = e.timeMs;
+            }
+
+            // The page tracks the fingers directly, damage right away so the update lands on the next frame
+            cursor_view->get_layout()->on_move_swipe(delta);
+            g_pHyprRenderer->damageMonitor(cursor_monitor);
+            g_pCompositor->scheduleFrameForMonitor(cursor_monitor);
         }
     }
     return res;
 }
 
-bool HTManager::swipe_end()
+bool HTManager::swipe_end(uint32_t time_ms)
 {
-    const PHTVIEW cursor_view = get_view_from_cursor();
+    const PHTVIEW& cursor_view = get_view_from_cursor();
     if (cursor_view == nullptr || swipe_state == HT_SWIPE_NONE)
         return false;
 
@@ -330,7 +384,10 @@ bool HTManager::swipe_end()
         break;
     }
     case HT_SWIPE_MOVE: {
-        const WORKSPACEID ws_id = cursor_view->layout->on_move_swipe_end();
+        // fingers that rested before lifting shouldn't flick
+        if (time_ms - swipe_last_ms > 100)
+            swipe_velocity = {};
+        const WORKSPACEID ws_id = cursor_view->get_layout()->on_move_swipe_end(swipe_velocity);
         cursor_view->move_id(ws_id, false);
         break;
     }
@@ -340,5 +397,176 @@ bool HTManager::swipe_end()
 
     swipe_state = HT_SWIPE_NONE;
     swipe_amt = 0.0;
+    swipe_axis = 0;
+    return true;
+}
+
+static Vector2D touch_to_global(const PHLMONITOR &monitor, const Vector2D &pos)
+{
+    return monitor->m_position + pos * monitor->m_size;
+}
+
+bool HTManager::touch_down(ITouch::SDownEvent e)
+{
+    const int ENABLED = HTConfig::value<Hyprlang::INT>("touch:enabled");
+
+    PHLMONITOR monitor = touch_monitor.lock();
+    if (touch_points.empty())
+    {
+        // Same monitor Hyprland maps the touch device to
+        if (e.device != nullptr && !e.device->m_boundOutput.empty())
+            monitor = g_pCompositor->getMonitorFromName(e.device->m_boundOutput);
+        if (monitor == nullptr)
+            monitor = Desktop::focusState()->monitor();
+    }
+    if (monitor == nullptr)
+        return false;
+
+    const PHTVIEW& view = get_view_from_monitor(monitor);
+    if (view == nullptr || !view->active)
+        return false;
+    // Overview still swallows touch when touch support is off, like it always did
+    if (!ENABLED || view->closing)
+        return true;
+
+    const Vector2D pos = touch_to_global(monitor, e.pos);
+    touch_points.push_back(HTTouchPoint{e.touchID, pos, pos, e.timeMs});
+
+    if (touch_points.size() == 1)
+    {
+        touch_monitor = monitor;
+        touch_state = HT_TOUCH_TAP;
+        g_pPointerManager->warpTo(pos);
+    }
+    else if (touch_points.size() == 2 && touch_state != HT_TOUCH_DRAG)
+    {
+        touch_state = HT_TOUCH_PINCH;
+        touch_pinch_start_dist = std::max(1.0, touch_points[0].pos.distance(touch_points[1].pos));
+        touch_pinch_perc = 1.f;
+    }
+
+    return true;
+}
+
+bool HTManager::touch_motion(ITouch::SMotionEvent e)
+{
+    const PHLMONITOR monitor = touch_monitor.lock();
+    if (touch_state == HT_TOUCH_NONE || monitor == nullptr)
+        return cursor_view_active();
+
+    const PHTVIEW& view = get_view_from_monitor(monitor);
+    if (view == nullptr)
+        return false;
+
+    auto point = std::ranges::find(touch_points, e.touchID, &HTTouchPoint::id);
+    if (point == touch_points.end())
+        return true;
+
+    const Vector2D pos = touch_to_global(monitor, e.pos);
+    const Vector2D delta = pos - point->pos;
+    point->pos = pos;
+
+    switch (touch_state)
+    {
+    case HT_TOUCH_TAP: {
+        const float TAP_DISTANCE = HTConfig::value<Hyprlang::FLOAT>("touch:tap_distance");
+        const int LONG_PRESS_MS = HTConfig::value<Hyprlang::INT>("touch:long_press_ms");
+        if (pos.distance(point->start_pos) <= TAP_DISTANCE)
+            break;
+
+        if (e.timeMs - point->down_ms >= (uint32_t)LONG_PRESS_MS)
+        {
+            // Long press then move picks up the window under the finger, exactly like a mouse drag
+            g_pPointerManager->warpTo(point->start_pos);
+            if (!start_window_drag())
+            {
+                touch_state = HT_TOUCH_PAN;
+                break;
+            }
+            touch_state = HT_TOUCH_DRAG;
+            g_pPointerManager->warpTo(pos);
+            g_pInputManager->simulateMouseMovement();
+        }
+        else
+        {
+            touch_state = HT_TOUCH_PAN;
+            view->get_layout()->on_pan((pos - point->start_pos) * monitor->m_scale);
+        }
+        break;
+    }
+    case HT_TOUCH_DRAG:
+        g_pPointerManager->warpTo(pos);
+        g_pInputManager->simulateMouseMovement();
+        break;
+    case HT_TOUCH_PAN:
+        view->get_layout()->on_pan(delta * monitor->m_scale);
+        break;
+    case HT_TOUCH_PINCH: {
+        if (touch_points.size() < 2)
+            break;
+        // Pinching in closes the overview, spreading back out reopens it
+        const double dist = touch_points[0].pos.distance(touch_points[1].pos);
+        touch_pinch_perc = std::clamp((float)(dist / touch_pinch_start_dist), 0.01f, 1.f);
+        view->get_layout()->close_open_lerp(touch_pinch_perc);
+        break;
+    }
+    case HT_TOUCH_NONE:
+        break;
+    }
+
+    g_pHyprRenderer->damageMonitor(monitor);
+    return true;
+}
+
+bool HTManager::touch_up(ITouch::SUpEvent e)
+{
+    const PHLMONITOR monitor = touch_monitor.lock();
+    if (touch_state == HT_TOUCH_NONE || monitor == nullptr)
+    {
+        touch_points.clear();
+        touch_state = HT_TOUCH_NONE;
+        return cursor_view_active();
+    }
+
+    const PHTVIEW& view = get_view_from_monitor(monitor);
+
+    auto point = std::ranges::find(touch_points, e.touchID, &HTTouchPoint::id);
+    if (point == touch_points.end())
+        return true;
+    const Vector2D pos = point->pos;
+    touch_points.erase(point);
+
+    // A gesture ends with its last finger
+    if (!touch_points.empty())
+        return true;
+
+    const touch_state_t state = touch_state;
+    touch_state = HT_TOUCH_NONE;
+    touch_monitor.reset();
+    if (view == nullptr)
+        return true;
+
+    switch (state)
+    {
+    case HT_TOUCH_TAP:
+        g_pPointerManager->warpTo(pos);
+        exit_to_workspace();
+        break;
+    case HT_TOUCH_DRAG:
+        g_pPointerManager->warpTo(pos);
+        end_window_drag();
+        break;
+    case HT_TOUCH_PINCH:
+        if (touch_pinch_perc >= 0.5)
+            view->show();
+        else
+            view->hide(false);
+        break;
+    case HT_TOUCH_PAN:
+    case HT_TOUCH_NONE:
+        break;
+    }
+
+    g_pHyprRenderer->damageMonitor(monitor);
     return true;
 }
@@ -19,6 +19,8 @@
 #include <map>
 
 #include "../../utils.h"
+#include "../../workspace_pool.h"
+#include "../../trace.h"
 #include "../config.hpp"
 #include "../globals.hpp"
 #include "../overview.hpp"
@@ -61,6 +63,9 @@ void HTLayoutColumn::rebuild_columns()
             continue;
         if (ws->m_isSpecialWorkspace)
             continue;
+        // empty workspaces only kept alive by the warm pool are not part of the topology
+        if (workspace_pool::is_parked(ws.lock()))
+            continue;
 
         int col = name_to_column(ws->m_name);
         int idx = name_to_index(ws->m_name);
@@ -178,6 +183,11 @@ WORKSPACEID HTLayoutColumn::get_ws_id_in_direction(int col_idx, int row_idx, std
     return target_col.workspaces[row_idx];
 }
 
+void HTLayoutColumn::on_move_swipe_begin()
+{
+    swipe_origin = offset->value();
+}
+
 void HTLayoutColumn::on_move_swipe(Vector2D delta)
 {
     const PHLMONITOR monitor = get_monitor();
@@ -195,26 +205,39 @@ void HTLayoutColumn::on_move_swipe(Vector2D delta)
 
     const CBox min_ws = calculate_ws_box(0, 0, HT_VIEW_CLOSED);
     const CBox max_ws = calculate_ws_box(num_cols - 1, max_rows - 1, HT_VIEW_CLOSED);
+    const Vector2D stride = calculate_ws_box(1, 1, HT_VIEW_CLOSED).pos() - min_ws.pos();
 
     Vector2D new_offset = offset->value() + delta / MOVE_DISTANCE * max_ws.w;
-    new_offset = new_offset.clamp(Vector2D{-max_ws.x, -max_ws.y}, Vector2D{-min_ws.x, -min_ws.y});
+    new_offset = clamp_swipe_offset(new_offset, stride, Vector2D{-max_ws.x, -max_ws.y}, Vector2D{-min_ws.x, -min_ws.y});
 
     offset->resetAllCallbacks();
     offset->setValueAndWarp(new_offset);
 }
 
-WORKSPACEID HTLayoutColumn::on_move_swipe_end()
+WORKSPACEID HTLayoutColumn::on_move_swipe_end(Vector2D velocity)
 {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return WORKSPACE_INVALID;
 
+    const float MOVE_DISTANCE = HTConfig::value<Hyprlang::FLOAT>("gestures:move_distance");
+    const float FLICK_TIME = HTConfig::value<Hyprlang::FLOAT>("gestures:move_flick_time");
+
     build_overview_layout(HT_VIEW_CLOSED);
+
+    const CBox min_ws = calculate_ws_box(0, 0, HT_VIEW_CLOSED);
+    const Vector2D stride = calculate_ws_box(1, 1, HT_VIEW_CLOSED).pos() - min_ws.pos();
+
+    // Snap to the tile closest to where the page would come to rest if it kept gliding for FLICK_TIME, so a short
+    // fast flick still changes workspace
+    Vector2D projected = offset->value() + velocity * FLICK_TIME / MOVE_DISTANCE * min_ws.w;
+    projected = projected.clamp(swipe_origin - stride, swipe_origin + stride);
+
     WORKSPACEID closest = WORKSPACE_INVALID;
     double closest_dist = 1e9;
     for (const auto &[ws_id, box] : overview_layout)
     {
-        const float dist_sq = offset->value().distanceSq(Vector2D{-box.box.x, -box.box.y});
+        const float dist_sq = projected.distanceSq(Vector2D{-box.box.x, -box.box.y});
         if (dist_sq < closest_dist)
         {
             closest_dist = dist_sq;
@@ -224,6 +247,16 @@ WORKSPACEID HTLayoutColumn::on_move_swipe_end()
     return closest;
 }
 
+bool HTLayoutColumn::on_mouse_axis(const HTAxisEvent &e)
+{
+    return pan_offset_with_axis(offset, e);
+}
+
+void HTLayoutColumn::on_pan(Vector2D delta)
+{
+    pan_offset(offset, delta, false);
+}
+
 void HTLayoutColumn::close_open_lerp(float perc)
 {
     const PHLMONITOR monitor = get_monitor();
@@ -235,7 +268,7 @@ void HTLayoutColumn::close_open_lerp(float perc)
     int max_rows = get_max_rows();
 
     double open_scale = calculate_ws_box(0, 0, HT_VIEW_OPENED).w / monitor->m_transformedSize.x;
-    Vector2D open_pos = {0, 0};
+    Vector2D open_pos = open_offset_for(monitor->m_activeWorkspace->m_id, {0, 0});
 
     build_overview_layout(HT_VIEW_CLOSED);
     double close_scale = 1.;
@@ -285,7 +318,35 @@ void HTLayoutColumn::on_show(CallbackFun on_complete)
 
     // Animate to overview position
     *scale = calculate_ws_box(0, 0, HT_VIEW_OPENED).w / monitor->m_transformedSize.x;
-    *offset = {0, 0};
+    *offset = open_offset_for(current_id, {0, 0});
+}
+
+Vector2D HTLayoutColumn::open_offset_for(WORKSPACEID ws_id, Vector2D from)
+{
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor == nullptr)
+        return from;
+
+    const auto [col_idx, row_idx] = get_ws_grid_position(ws_id);
+    if (col_idx == -1)
+        return from;
+
+    const float GAP_SIZE = HTConfig::value<Hyprlang::FLOAT>("gap_size") * monitor->m_scale;
+    const Vector2D mon_size = monitor->m_transformedSize;
+    const CBox box = calculate_ws_box(col_idx, row_idx, HT_VIEW_OPENED).translate(from);
+
+    // Move by as little as possible
+    Vector2D shift{};
+    if (box.x < GAP_SIZE)
+        shift.x = GAP_SIZE - box.x;
+    else if (box.x + box.w > mon_size.x - GAP_SIZE)
+        shift.x = mon_size.x - GAP_SIZE - (box.x + box.w);
+    if (box.y < GAP_SIZE)
+        shift.y = GAP_SIZE - box.y;
+    else if (box.y + box.h > mon_size.y - GAP_SIZE)
+        shift.y = mon_size.y - GAP_SIZE - (box.y + box.h);
+
+    return from + shift;
 }
 
 void HTLayoutColumn::on_hide(CallbackFun on_complete)
@@ -328,10 +389,18 @@ void HTLayoutColumn::on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun
             offset->setCallbackOnEnd(on_complete);
     });
 
-    const PHTVIEW par_view = ht_manager->get_view_from_id(view_id);
-    if (par_view == nullptr || par_view->active)
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
+    if (par_view == nullptr)
         return;
 
+    // Moving inside the open overview only has to keep the new tile on screen
+    if (par_view->active)
+    {
+        rebuild_columns();
+        *offset = open_offset_for(new_id, offset->goal());
+        return;
+    }
+
     // Prevent the workspace from animating
     auto old_ws = g_pCompositor->getWorkspaceByID(old_id);
     auto new_ws = g_pCompositor->getWorkspaceByID(new_id);
@@ -390,6 +459,15 @@ float HTLayoutColumn::drag_window_scale()
     return it->second.box.w / monitor->m_transformedSize.x;
 }
 
+void HTLayoutColumn::stop_animations()
+{
+    HTLayoutBase::stop_animations();
+    scale->resetAllCallbacks();
+    scale->warp();
+    offset->resetAllCallbacks();
+    offset->warp();
+}
+
 void HTLayoutColumn::init_position()
 {
     const PHLMONITOR monitor = get_monitor();
@@ -410,14 +488,28 @@ void HTLayoutColumn::init_position()
     scale->setValueAndWarp(1.f);
 }
 
+void HTLayoutColumn::on_geometry_changed(bool open)
+{
+    const PHLMONITOR monitor = get_monitor();
+    if (!open || monitor == nullptr)
+    {
+        init_position();
+        return;
+    }
+
+    // on_show would warp back to the closed position first, only retarget from where the overview is now
+    rebuild_columns();
+    *scale = calculate_ws_box(0, 0, HT_VIEW_OPENED).w / monitor->m_transformedSize.x;
+    *offset = open_offset_for(monitor->m_activeWorkspace->m_id, {0, 0});
+}
+
 CBox HTLayoutColumn::calculate_ws_box(int col_idx, int row_idx, HTViewStage stage)
 {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return {};
 
-    rebuild_columns();
-
+    // columns must already be rebuilt by the caller, this runs once per tile per frame
     const int num_cols = get_column_count();
     const int max_rows = get_max_rows();
     const float GAP_SIZE = HTConfig::value<Hyprlang::FLOAT>("gap_size") * monitor->m_scale;
@@ -442,6 +534,20 @@ CBox HTLayoutColumn::calculate_ws_box(int col_idx, int row_idx, HTViewStage stag
         render_x = render_y * mon_aspect;
     }
 
+    // Don't shrink tiles past the minimum, the canvas grows past the monitor instead and is panned
+    const float MIN_TILE_WIDTH = HTConfig::value<Hyprlang::FLOAT>("column:min_tile_width") * monitor->m_scale;
+    if (MIN_TILE_WIDTH > 0 && render_x < MIN_TILE_WIDTH)
+    {
+        render_x = std::min((double)MIN_TILE_WIDTH, monitor->m_transformedSize.x - GAP_SIZE * 2);
+        render_y = render_x / mon_aspect;
+
+        // Still center on the axis that fits
+        const Vector2D canvas = Vector2D{num_cols * (render_x + GAP_SIZE), max_rows * (render_y + GAP_SIZE)} +
+                                Vector2D{GAP_SIZE, GAP_SIZE};
+        start_offset.x = std::max(0.0, (monitor->m_transformedSize.x - canvas.x) / 2.f);
+        start_offset.y = std::max(0.0, (monitor->m_transformedSize.y - canvas.y) / 2.f);
+    }
+
     float use_scale = scale->value();
     Vector2D use_offset = offset->value();
     if (stage == HT_VIEW_CLOSED)
@@ -463,6 +569,8 @@ CBox HTLayoutColumn::calculate_ws_box(int col_idx, int row_idx, HTViewStage stag
 
 void HTLayoutColumn::build_overview_layout(HTViewStage stage)
 {
+    HT_TRACE_SCOPE("build_overview_layout", view_id);
+
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return;
@@ -499,12 +607,17 @@ void HTLayoutColumn::build_overview_layout(HTViewStage stage)
         Desktop::focusState()->rawMonitorFocus(last_monitor);
 }
 
+bool HTLayoutColumn::is_animating()
+{
+    return HTLayoutBase::is_animating() || scale->isBeingAnimated() || offset->isBeingAnimated();
+}
+
 void HTLayoutColumn::render()
 {
     HTLayoutBase::render();
     CScopeGuard x([this] { post_render(); });
 
-    const PHTVIEW par_view = ht_manager->get_view_from_id(view_id);
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
     if (par_view == nullptr)
         return;
     const PHLMONITOR monitor = par_view->get_monitor();
@@ -521,7 +634,7 @@ void HTLayoutColumn::render()
 
 	const auto time = Time::steadyNow();
 
-    g_pHyprRenderer->damageMonitor(monitor);
+    schedule_next_frame();
     g_pHyprOpenGL->m_renderData.pCurrentMonData->blurFBShouldRender = true;
     CBox monitor_box = {{0, 0}, monitor->m_transformedSize};
 
@@ -565,6 +678,8 @@ void HTLayoutColumn::render()
         if (global_box.expand(BORDERSIZE).intersection(global_mon_box).empty())
             continue;
 
+        HT_TRACE_SCOPE("render_tile", ws_id);
+
         const CGradientValueData border_col = monitor->m_activeWorkspace->m_id == ws_id ? *ACTIVECOL : *INACTIVECOL;
         CBox border_box = ws_layout.box;
 
@@ -574,6 +689,13 @@ void HTLayoutColumn::render()
         bdata.borderSize = BORDERSIZE;
         g_pHyprRenderer->m_renderPass.add(makeUnique<CBorderPassElement>(bdata));
 
+        // Neighbours prefetched after the last move don't need a cold render
+        if (workspace != nullptr && render_thumbnail(ws_id, ws_layout.box))
+        {
+            render_filter(ws_id, ws_layout.box);
+            continue;
+        }
+
         if (workspace != nullptr)
         {
             monitor->m_activeWorkspace = workspace;
@@ -594,6 +716,8 @@ void HTLayoutColumn::render()
             ((render_workspace_t)(render_workspace_hook->m_original))(g_pHyprRenderer.get(), monitor, workspace, time,
                                                                       render_box);
         }
+
+        render_filter(ws_id, ws_layout.box);
     }
 
     monitor->m_activeWorkspace = start_workspace;
@@ -608,6 +732,8 @@ void HTLayoutColumn::render()
         // make sure box is not empty
         if (ws_box.width > 0.01 && ws_box.height > 0.01)
         {
+            HT_TRACE_SCOPE("render_tile", start_workspace->m_id);
+
             // renderModif translation used by renderWorkspace is weird so need
             // to scale the translation up as well. Geometry is also calculated from pixel size and not transformed
             // size??
@@ -628,23 +754,9 @@ void HTLayoutColumn::render()
 
             ((render_workspace_t)(render_workspace_hook->m_original))(g_pHyprRenderer.get(), monitor, start_workspace,
                                                                       time, render_box);
+            render_filter(start_workspace->m_id, ws_box);
         }
     }
 
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
-    if (cursor_view == nullptr)
-        return;
-    const SP<Layout::ITarget> target = g_layoutManager->dragController()->target();
-    if (target == nullptr)
-        return;
-    const PHLWINDOW dragged_window = target->window();
-    if (dragged_window == nullptr)
-        return;
-    const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
-    const CBox window_box = dragged_window->getWindowMainSurfaceBox()
-                                .translate(-mouse_coords)
-                                .scale(cursor_view->layout->drag_window_scale())
-                                .translate(mouse_coords);
-    if (!window_box.intersection(monitor->logicalBox()).empty())
-        render_window_at_box(dragged_window, monitor, time, window_box);
+    render_drag_preview(monitor, time);
 }
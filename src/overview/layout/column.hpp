@@ -24,6 +24,9 @@ class HTLayoutColumn : public HTLayoutBase {
     int get_column_count();
     int get_max_rows();
     std::pair<int, int> get_ws_grid_position(WORKSPACEID ws_id); // Returns (col_idx, row_idx)
+    // Open overview offset that brings ws_id's tile on screen starting from the offset from, which only changes
+    // when the canvas is larger than the monitor (see column:min_tile_width)
+    Vector2D open_offset_for(WORKSPACEID ws_id, Vector2D from);
 
   public:
     HTLayoutColumn(VIEWID view_id);
@@ -37,14 +40,21 @@ class HTLayoutColumn : public HTLayoutBase {
     virtual void on_show(CallbackFun on_complete);
     virtual void on_hide(CallbackFun on_complete);
     virtual void on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun on_complete);
+    virtual void on_move_swipe_begin();
     virtual void on_move_swipe(Vector2D delta);
-    virtual WORKSPACEID on_move_swipe_end();
+    virtual WORKSPACEID on_move_swipe_end(Vector2D velocity);
 
     virtual WORKSPACEID get_ws_id_in_direction(int x, int y, std::string& direction);
 
+    virtual bool on_mouse_axis(const HTAxisEvent& e);
+    virtual void on_pan(Vector2D delta);
+
     virtual bool should_render_window(PHLWINDOW window);
     virtual float drag_window_scale();
+    virtual void stop_animations();
     virtual void init_position();
+    virtual void on_geometry_changed(bool open);
     virtual void build_overview_layout(HTViewStage stage);
     virtual void render();
+    virtual bool is_animating();
 };
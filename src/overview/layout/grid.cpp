@@ -16,6 +16,7 @@
 #include <hyprutils/math/Vector2D.hpp>
 #include <hyprutils/utils/ScopeGuard.hpp>
 
+#include "../../trace.h"
 #include "../config.hpp"
 #include "../globals.hpp"
 #include "../overview.hpp"
@@ -69,6 +70,10 @@ WORKSPACEID HTLayoutGrid::get_ws_id_in_direction(int x, int y, std::string& dire
     return get_ws_id_from_xy(x, y);
 }
 
+void HTLayoutGrid::on_move_swipe_begin() {
+    swipe_origin = offset->value();
+}
+
 void HTLayoutGrid::on_move_swipe(Vector2D delta) {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
@@ -79,24 +84,35 @@ void HTLayoutGrid::on_move_swipe(Vector2D delta) {
     const int COLS = HTConfig::value<Hyprlang::INT>("grid:cols");
     const CBox min_ws = calculate_ws_box(0, 0, HT_VIEW_CLOSED);
     const CBox max_ws = calculate_ws_box(COLS - 1, ROWS - 1, HT_VIEW_CLOSED);
+    const Vector2D stride = calculate_ws_box(1, 1, HT_VIEW_CLOSED).pos() - min_ws.pos();
 
     Vector2D new_offset = offset->value() + delta / MOVE_DISTANCE * max_ws.w;
-    new_offset = new_offset.clamp(Vector2D {-max_ws.x, -max_ws.y}, Vector2D {-min_ws.x, -min_ws.y});
+    new_offset =
+        clamp_swipe_offset(new_offset, stride, Vector2D {-max_ws.x, -max_ws.y}, Vector2D {-min_ws.x, -min_ws.y});
 
     offset->resetAllCallbacks();
     offset->setValueAndWarp(new_offset);
 }
 
-WORKSPACEID HTLayoutGrid::on_move_swipe_end() {
+WORKSPACEID HTLayoutGrid::on_move_swipe_end(Vector2D velocity) {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return WORKSPACE_INVALID;
 
+    const float MOVE_DISTANCE = HTConfig::value<Hyprlang::FLOAT>("gestures:move_distance");
+    const float FLICK_TIME = HTConfig::value<Hyprlang::FLOAT>("gestures:move_flick_time");
+    const CBox min_ws = calculate_ws_box(0, 0, HT_VIEW_CLOSED);
+    const Vector2D stride = calculate_ws_box(1, 1, HT_VIEW_CLOSED).pos() - min_ws.pos();
+
+    // snap to where the page would rest after gliding for FLICK_TIME
+    Vector2D projected = offset->value() + velocity * FLICK_TIME / MOVE_DISTANCE * min_ws.w;
+    projected = projected.clamp(swipe_origin - stride, swipe_origin + stride);
+
     build_overview_layout(HT_VIEW_CLOSED);
     WORKSPACEID closest = WORKSPACE_INVALID;
     double closest_dist = 1e9;
     for (const auto& [ws_id, box] : overview_layout) {
-        const float dist_sq = offset->value().distanceSq(Vector2D {-box.box.x, -box.box.y});
+        const float dist_sq = projected.distanceSq(Vector2D {-box.box.x, -box.box.y});
         if (dist_sq < closest_dist) {
             closest_dist = dist_sq;
             closest = ws_id;
@@ -105,6 +121,14 @@ WORKSPACEID HTLayoutGrid::on_move_swipe_end() {
     return closest;
 }
 
+bool HTLayoutGrid::on_mouse_axis(const HTAxisEvent& e) {
+    return pan_offset_with_axis(offset, e);
+}
+
+void HTLayoutGrid::on_pan(Vector2D delta) {
+    pan_offset(offset, delta, false);
+}
+
 void HTLayoutGrid::close_open_lerp(float perc) {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
@@ -165,7 +189,7 @@ void HTLayoutGrid::on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun o
             offset->setCallbackOnEnd(on_complete);
     });
 
-    const PHTVIEW par_view = ht_manager->get_view_from_id(view_id);
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
     if (par_view == nullptr || par_view->active)
         return;
 
@@ -206,6 +230,14 @@ float HTLayoutGrid::drag_window_scale() {
     return scale->value();
 }
 
+void HTLayoutGrid::stop_animations() {
+    HTLayoutBase::stop_animations();
+    scale->resetAllCallbacks();
+    scale->warp();
+    offset->resetAllCallbacks();
+    offset->warp();
+}
+
 void HTLayoutGrid::init_position() {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
@@ -265,6 +297,8 @@ CBox HTLayoutGrid::calculate_ws_box(int x, int y, HTViewStage stage) {
 };
 
 void HTLayoutGrid::build_overview_layout(HTViewStage stage) {
+    HT_TRACE_SCOPE("build_overview_layout", view_id);
+
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return;
@@ -293,11 +327,15 @@ void HTLayoutGrid::build_overview_layout(HTViewStage stage) {
         Desktop::focusState()->rawMonitorFocus(last_monitor);
 }
 
+bool HTLayoutGrid::is_animating() {
+    return HTLayoutBase::is_animating() || scale->isBeingAnimated() || offset->isBeingAnimated();
+}
+
 void HTLayoutGrid::render() {
     HTLayoutBase::render();
     CScopeGuard x([this] { post_render(); });
 
-    const PHTVIEW par_view = ht_manager->get_view_from_id(view_id);
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
     if (par_view == nullptr)
         return;
     const PHLMONITOR monitor = par_view->get_monitor();
@@ -314,7 +352,7 @@ void HTLayoutGrid::render() {
 
     const auto time = Time::steadyNow();
 
-    g_pHyprRenderer->damageMonitor(monitor);
+    schedule_next_frame();
     g_pHyprOpenGL->m_renderData.pCurrentMonData->blurFBShouldRender = true;
     CBox monitor_box = {{0, 0}, monitor->m_transformedSize};
 
@@ -360,6 +398,8 @@ void HTLayoutGrid::render() {
         if (global_box.expand(BORDERSIZE).intersection(global_mon_box).empty())
             continue;
 
+        HT_TRACE_SCOPE("render_tile", ws_id);
+
         const CGradientValueData border_col =
             monitor->m_activeWorkspace->m_id == ws_id ? *ACTIVECOL : *INACTIVECOL;
         CBox border_box = ws_layout.box;
@@ -370,6 +410,12 @@ void HTLayoutGrid::render() {
         data.borderSize = BORDERSIZE;
         g_pHyprRenderer->m_renderPass.add(makeUnique<CBorderPassElement>(data));
 
+        // Neighbours prefetched after the last move don't need a cold render
+        if (workspace != nullptr && render_thumbnail(ws_id, ws_layout.box)) {
+            render_filter(ws_id, ws_layout.box);
+            continue;
+        }
+
         if (workspace != nullptr) {
             monitor->m_activeWorkspace = workspace;
             g_pDesktopAnimationManager->startAnimation(
@@ -405,6 +451,8 @@ void HTLayoutGrid::render() {
                 render_box
             );
         }
+
+        render_filter(ws_id, ws_layout.box);
     }
 
     monitor->m_activeWorkspace = start_workspace;
@@ -421,6 +469,8 @@ void HTLayoutGrid::render() {
         CBox ws_box = overview_layout[start_workspace->m_id].box;
         // make sure box is not empty
         if (ws_box.width > 0.01 && ws_box.height > 0.01) {
+            HT_TRACE_SCOPE("render_tile", start_workspace->m_id);
+
             // renderModif translation used by renderWorkspace is weird so need
             // to scale the translation up as well. Geometry is also calculated from pixel size and not transformed size??
             CBox render_box = {{ws_box.pos() / scale->value()}, ws_box.size()};
@@ -445,23 +495,9 @@ void HTLayoutGrid::render() {
                 time,
                 render_box
             );
+            render_filter(start_workspace->m_id, ws_box);
         }
     }
 
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
-    if (cursor_view == nullptr)
-        return;
-    const SP<Layout::ITarget> target = g_layoutManager->dragController()->target();
-    if (target == nullptr)
-        return;
-    const PHLWINDOW dragged_window = target->window();
-    if (dragged_window == nullptr)
-        return;
-    const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
-    const CBox window_box = dragged_window->getWindowMainSurfaceBox()
-                                .translate(-mouse_coords)
-                                .scale(cursor_view->layout->drag_window_scale())
-                                .translate(mouse_coords);
-    if (!window_box.intersection(monitor->logicalBox()).empty())
-        render_window_at_box(dragged_window, monitor, time, window_box);
+    render_drag_preview(monitor, time);
 }
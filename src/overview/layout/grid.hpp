@@ -22,14 +22,20 @@ class HTLayoutGrid: public HTLayoutBase {
     virtual void on_show(CallbackFun on_complete);
     virtual void on_hide(CallbackFun on_complete);
     virtual void on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun on_complete);
+    virtual void on_move_swipe_begin();
     virtual void on_move_swipe(Vector2D delta);
-    virtual WORKSPACEID on_move_swipe_end();
+    virtual WORKSPACEID on_move_swipe_end(Vector2D velocity);
 
     virtual WORKSPACEID get_ws_id_in_direction(int x, int y, std::string& direction);
 
+    virtual bool on_mouse_axis(const HTAxisEvent& e);
+    virtual void on_pan(Vector2D delta);
+
     virtual bool should_render_window(PHLWINDOW window);
     virtual float drag_window_scale();
+    virtual void stop_animations();
     virtual void init_position();
     virtual void build_overview_layout(HTViewStage stage);
     virtual void render();
+    virtual bool is_animating();
 };
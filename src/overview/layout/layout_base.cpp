@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <any>
+#include <cmath>
 #include <sstream>
 
 #define private public
@@ -8,6 +10,8 @@
 #include <hyprland/src/managers/input/InputManager.hpp>
 #include <hyprland/src/render/Renderer.hpp>
 #include <hyprland/src/render/pass/ClearPassElement.hpp>
+#include <hyprland/src/render/pass/RectPassElement.hpp>
+#include <hyprland/src/render/pass/TexPassElement.hpp>
 #undef private
 
 #include <hyprland/protocols/wlr-layer-shell-unstable-v1.hpp>
@@ -15,6 +19,7 @@
 
 #include "../config.hpp"
 #include "../globals.hpp"
+#include "../overview.hpp"
 #include "../pass/pass_element.hpp"
 #include "../types.hpp"
 #include "layout_base.hpp"
@@ -25,12 +30,23 @@ HTLayoutBase::HTLayoutBase(VIEWID new_view_id) : view_id(new_view_id)
                                          g_pConfigManager->getAnimationPropertyConfig("workspaces"), AVARDAMAGE_NONE);
 }
 
+Vector2D HTLayoutBase::clamp_swipe_offset(Vector2D new_offset, Vector2D stride, Vector2D min, Vector2D max)
+{
+    new_offset = new_offset.clamp(swipe_origin - stride, swipe_origin + stride);
+    return new_offset.clamp(min, max);
+}
+
+void HTLayoutBase::on_move_swipe_begin()
+{
+    ;
+}
+
 void HTLayoutBase::on_move_swipe(Vector2D delta)
 {
     ;
 }
 
-WORKSPACEID HTLayoutBase::on_move_swipe_end()
+WORKSPACEID HTLayoutBase::on_move_swipe_end(Vector2D velocity)
 {
     return WORKSPACE_INVALID;
 }
@@ -60,11 +76,97 @@ WORKSPACEID HTLayoutBase::get_ws_id_in_direction(int x, int y, std::string &dire
     return get_ws_id_from_xy(x, y);
 }
 
-bool HTLayoutBase::on_mouse_axis(double delta)
+bool HTLayoutBase::get_pan_range(Vector2D &min, Vector2D &max)
+{
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor == nullptr || overview_layout.empty())
+        return false;
+
+    const float GAP_SIZE = HTConfig::value<Hyprlang::FLOAT>("gap_size") * monitor->m_scale;
+
+    Vector2D content_min{INFINITY, INFINITY};
+    Vector2D content_max{-INFINITY, -INFINITY};
+    for (const auto &[ws_id, ws_layout] : overview_layout)
+    {
+        content_min.x = std::min(content_min.x, ws_layout.box.x);
+        content_min.y = std::min(content_min.y, ws_layout.box.y);
+        content_max.x = std::max(content_max.x, ws_layout.box.x + ws_layout.box.w);
+        content_max.y = std::max(content_max.y, ws_layout.box.y + ws_layout.box.h);
+    }
+
+    min = monitor->m_transformedSize - content_max - Vector2D{GAP_SIZE, GAP_SIZE};
+    max = Vector2D{GAP_SIZE, GAP_SIZE} - content_min;
+
+    // Content that fits on an axis stays where it is
+    if (min.x > max.x)
+        min.x = max.x = 0;
+    if (min.y > max.y)
+        min.y = max.y = 0;
+
+    return min != max;
+}
+
+void HTLayoutBase::pan_offset(PHLANIMVAR<Vector2D> &offset, Vector2D delta, bool animate)
+{
+    Vector2D min, max;
+    if (!get_pan_range(min, max))
+        return;
+
+    // The range is relative to offset->value(), which the goal may already be ahead of
+    const Vector2D from = animate ? offset->goal() : offset->value();
+    const Vector2D shift = (from - offset->value() + delta).clamp(min, max);
+
+    if (animate)
+        *offset = offset->value() + shift;
+    else
+        offset->setValueAndWarp(offset->value() + shift);
+}
+
+bool HTLayoutBase::pan_offset_with_axis(PHLANIMVAR<Vector2D> &offset, const HTAxisEvent &e)
+{
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor == nullptr)
+        return false;
+
+    // How far ahead lifting the fingers throws the content, the offset animation's curve decelerates it
+    constexpr float THROW_MS = 200.f;
+    const float SCROLL_SPEED = HTConfig::value<Hyprlang::FLOAT>("scroll_speed");
+
+    if (!e.continuous)
+    {
+        pan_offset(offset, -e.delta * SCROLL_SPEED * 10.f, true);
+        return true;
+    }
+
+    if (e.delta == Vector2D{})
+    {
+        pan_offset(offset, axis_velocity * THROW_MS, true);
+        axis_velocity = {};
+        return true;
+    }
+
+    const Vector2D delta = -e.delta * SCROLL_SPEED * monitor->m_scale;
+    const uint32_t elapsed_ms = e.time_ms - axis_last_ms;
+    if (elapsed_ms > 100)
+        axis_velocity = {};
+    else if (elapsed_ms > 0)
+        axis_velocity = axis_velocity * 0.5 + delta / elapsed_ms * 0.5;
+    axis_last_ms = e.time_ms;
+
+    pan_offset(offset, delta, false);
+    return true;
+}
+
+bool HTLayoutBase::on_mouse_axis(const HTAxisEvent &e)
 {
     return false;
 }
 
+void HTLayoutBase::on_pan(Vector2D delta)
+{
+    ;
+}
+
 bool HTLayoutBase::should_manage_mouse()
 {
     return true;
@@ -89,6 +191,42 @@ void HTLayoutBase::init_position()
     ;
 }
 
+bool HTLayoutBase::is_animating()
+{
+    return focus_progress->isBeingAnimated();
+}
+
+void HTLayoutBase::schedule_next_frame()
+{
+    if (!is_animating() && damage_hooked)
+        return;
+
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor != nullptr)
+        g_pHyprRenderer->damageMonitor(monitor);
+}
+
+void HTLayoutBase::on_geometry_changed(bool open)
+{
+    // on_show only retargets the animations for every layout that doesn't override this
+    if (open)
+        on_show();
+    else
+        init_position();
+}
+
+void HTLayoutBase::stop_animations()
+{
+    focus_progress->resetAllCallbacks();
+    focus_progress->warp();
+}
+
+void HTLayoutBase::set_view_id(VIEWID new_view_id)
+{
+    view_id = new_view_id;
+    overview_layout.clear();
+}
+
 void HTLayoutBase::build_overview_layout(HTViewStage stage)
 {
     ;
@@ -103,7 +241,7 @@ void HTLayoutBase::update_focus_state(HTViewStage stage)
         return;
 
     const WORKSPACEID current_id = monitor->m_activeWorkspace->m_id;
-    const PHTVIEW view = ht_manager ? ht_manager->get_view_from_id(view_id) : nullptr;
+    const PHTVIEW& view = ht_manager->get_view_from_id(view_id);
     const bool overview_active = view != nullptr && view->active;
     const bool is_closing = view != nullptr && view->closing;
 
@@ -145,7 +283,7 @@ float HTLayoutBase::focus_scale_for_id(WORKSPACEID workspace_id, HTViewStage sta
     if (stage == HT_VIEW_CLOSED)
         return 1.f;
 
-    const PHTVIEW view = ht_manager ? ht_manager->get_view_from_id(view_id) : nullptr;
+    const PHTVIEW& view = ht_manager->get_view_from_id(view_id);
     if (view == nullptr || !view->active)
         return 1.f;
 
@@ -197,6 +335,70 @@ void HTLayoutBase::render()
     }
 }
 
+bool HTLayoutBase::render_thumbnail(WORKSPACEID ws_id, const CBox &box)
+{
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
+    if (par_view == nullptr || par_view->active || !par_view->navigating)
+        return false;
+
+    const SP<CTexture> texture = par_view->thumbnails.get(ws_id);
+    if (texture == nullptr)
+        return false;
+
+    CTexPassElement::SRenderData data;
+    data.tex = texture;
+    data.box = box;
+    g_pHyprRenderer->m_renderPass.add(makeUnique<CTexPassElement>(data));
+    return true;
+}
+
+void HTLayoutBase::render_filter(WORKSPACEID ws_id, const CBox &box)
+{
+    if (!ht_manager->filter_active())
+        return;
+
+    const PHLMONITOR monitor = get_monitor();
+    const PHLWORKSPACE workspace = g_pCompositor->getWorkspaceByID(ws_id);
+    if (monitor == nullptr)
+        return;
+
+    CRectPassElement::SRectData data;
+    data.color = CHyprColor{0, 0, 0, HTConfig::value<Hyprlang::FLOAT>("filter_dim")};
+
+    bool any_match = false;
+    std::vector<CBox> dimmed;
+    for (const auto &window : g_pCompositor->m_windows)
+    {
+        if (workspace == nullptr || window->m_workspace != workspace || !window->m_isMapped || window->isHidden())
+            continue;
+        if (ht_manager->filter_matches(window))
+        {
+            any_match = true;
+            continue;
+        }
+
+        // global logical coordinates to the monitor local pixels the tiles are laid out in
+        CBox window_box = get_global_window_box(window, ws_id);
+        window_box.translate(-monitor->m_position).scale(monitor->m_scale);
+        dimmed.push_back(window_box.intersection(box));
+    }
+
+    if (!any_match)
+    {
+        data.box = box;
+        g_pHyprRenderer->m_renderPass.add(makeUnique<CRectPassElement>(data));
+        return;
+    }
+
+    for (const CBox &window_box : dimmed)
+    {
+        if (window_box.empty())
+            continue;
+        data.box = window_box;
+        g_pHyprRenderer->m_renderPass.add(makeUnique<CRectPassElement>(data));
+    }
+}
+
 const std::string CLEAR_PASS_ELEMENT_NAME = "CClearPassElement";
 
 void HTLayoutBase::post_render()
@@ -213,7 +415,7 @@ void HTLayoutBase::post_render()
 
 PHLMONITOR HTLayoutBase::get_monitor()
 {
-    const auto par_view = ht_manager->get_view_from_id(view_id);
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
     if (par_view == nullptr)
         return nullptr;
     return par_view->get_monitor();
@@ -23,6 +23,25 @@ class HTLayoutBase {
     bool focus_inited = false;
     PHLANIMVAR<float> focus_progress;
 
+    // Offset of the layout when the current move swipe began
+    Vector2D swipe_origin;
+
+    // Keep a swipe offset within one tile (stride) of swipe_origin and inside [min, max], so a swipe only ever
+    // shows the tile it started on and one neighbour
+    Vector2D clamp_swipe_offset(Vector2D new_offset, Vector2D stride, Vector2D min, Vector2D max);
+
+    // Smoothed continuous scroll velocity in layout pixels per ms, thrown when the fingers lift
+    Vector2D axis_velocity;
+    uint32_t axis_last_ms = 0;
+
+    // How far the overview can be panned either way, from the layout built for the last frame so panning doesn't
+    // rebuild it. False if there is nothing to pan
+    bool get_pan_range(Vector2D& min, Vector2D& max);
+    // Pan offset by delta layout pixels, either following input exactly or animating towards it
+    void pan_offset(PHLANIMVAR<Vector2D>& offset, Vector2D delta, bool animate);
+    // Pan offset from a scroll event: wheel steps animate, smooth scrolling tracks 1:1 and is thrown on release
+    bool pan_offset_with_axis(PHLANIMVAR<Vector2D>& offset, const HTAxisEvent& e);
+
     void update_focus_state(HTViewStage stage);
     float focus_scale_for_id(WORKSPACEID workspace_id, HTViewStage stage);
     CBox apply_focus_scale(const CBox& box, WORKSPACEID workspace_id, HTViewStage stage);
@@ -50,15 +69,19 @@ class HTLayoutBase {
     virtual void on_hide(CallbackFun on_complete = nullptr) = 0;
     virtual void
     on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun on_complete = nullptr) = 0;
+    virtual void on_move_swipe_begin();
+    // delta is already locked to the axis of the swipe
     virtual void on_move_swipe(Vector2D delta);
-    // Returns the workspace id that the swipe should snap to
-    virtual WORKSPACEID on_move_swipe_end();
+    // Returns the workspace id that the swipe should snap to, velocity is in swipe units per ms
+    virtual WORKSPACEID on_move_swipe_end(Vector2D velocity);
 
     // Get the workspace up/down left/right relative to the workspace at (x, y)
     virtual WORKSPACEID get_ws_id_in_direction(int x, int y, std::string& direction);
 
     // Return true if should cancel
-    virtual bool on_mouse_axis(double delta);
+    virtual bool on_mouse_axis(const HTAxisEvent& e);
+    // One finger touch pan inside the open overview, delta in layout pixels
+    virtual void on_pan(Vector2D delta);
 
     // Should return true if when active, hyprtasking should manage the mouse button actions
     // (warping to appropriate position and smoothing the drag window, if it exists)
@@ -69,10 +92,29 @@ class HTLayoutBase {
     virtual float drag_window_scale();
     // Only to be called when closed, init/reset the position in case of config/monitor change
     virtual void init_position();
+    // A reload changed the geometry config: a closed layout re-inits its position, an open one animates to where
+    // the new geometry puts it instead of closing
+    virtual void on_geometry_changed(bool open);
+    // Finish all animations in place and drop their callbacks, for when the monitor goes away mid animation
+    virtual void stop_animations();
+    // Point the layout at a new monitor id, when a view is reused for a re-plugged monitor
+    void set_view_id(VIEWID new_view_id);
     // Populate overview_layout as if the overview was at a given stage
     virtual void build_overview_layout(HTViewStage stage);
     // Render the overview
     virtual void render();
+    // True while any of the layout's animated variables is moving
+    virtual bool is_animating();
+    // Called every frame the layout renders: asks for another only while something moves, so an idle overview
+    // stops rendering until input or a client's damage wakes it up
+    void schedule_next_frame();
+
+    // While navigating, draw ws_id from the view's prefetched snapshots instead of rendering it live. Returns
+    // false if there is no usable snapshot
+    bool render_thumbnail(WORKSPACEID ws_id, const CBox& box);
+
+    // While type-to-filter is active, dim the windows of ws_id that don't match, or the whole tile if none do
+    void render_filter(WORKSPACEID ws_id, const CBox& box);
 
     // Prevent simplification from happening in the plugin, remove all clear pass objects
     void post_render();
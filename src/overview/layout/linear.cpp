@@ -14,6 +14,8 @@
 #include <hyprutils/utils/ScopeGuard.hpp>
 #include <ranges>
 
+#include "../../workspace_pool.h"
+#include "../../trace.h"
 #include "../config.hpp"
 #include "../globals.hpp"
 #include "../render.hpp"
@@ -128,13 +130,10 @@ void HTLayoutLinear::on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun
     }
 }
 
-bool HTLayoutLinear::on_mouse_axis(double delta) {
-    if (!should_manage_mouse())
-        return false;
-
+double HTLayoutLinear::clamp_scroll_offset(double new_offset) {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
-        return false;
+        return 0.;
 
     const float GAP_SIZE = HTConfig::value<Hyprlang::FLOAT>("gap_size") * monitor->m_scale;
 
@@ -143,17 +142,10 @@ bool HTLayoutLinear::on_mouse_axis(double delta) {
         + GAP_SIZE;
 
     // Stay at 0 if not long enough
-    if (total_ws_width < monitor->m_transformedSize.x) {
-        *scroll_offset = 0.;
-        return true;
-    }
+    if (total_ws_width < monitor->m_transformedSize.x)
+        return 0.;
 
-    double new_offset = scroll_offset->goal()
-        + delta * HTConfig::value<Hyprlang::FLOAT>("linear:scroll_speed") * -10.f;
-
-    const float max_x = new_offset
-        + (overview_layout.size() * (GAP_SIZE + calculate_ws_box(0, 0, HT_VIEW_ANIMATING).w))
-        + GAP_SIZE;
+    const float max_x = new_offset + total_ws_width;
 
     // Snap to left
     if (new_offset > 0.)
@@ -163,10 +155,32 @@ bool HTLayoutLinear::on_mouse_axis(double delta) {
     if (max_x < monitor->m_transformedSize.x)
         new_offset = new_offset + (monitor->m_transformedSize.x - max_x);
 
-    *scroll_offset = new_offset;
+    return new_offset;
+}
+
+bool HTLayoutLinear::on_mouse_axis(const HTAxisEvent& e) {
+    if (!should_manage_mouse())
+        return false;
+
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor == nullptr)
+        return false;
+
+    *scroll_offset = clamp_scroll_offset(
+        scroll_offset->goal()
+        + (e.delta.x + e.delta.y) * HTConfig::value<Hyprlang::FLOAT>("linear:scroll_speed") * -10.f
+    );
     return true;
 }
 
+void HTLayoutLinear::on_pan(Vector2D delta) {
+    if (!should_manage_mouse())
+        return;
+
+    // the strip follows the finger
+    scroll_offset->setValueAndWarp(clamp_scroll_offset(scroll_offset->value() + delta.x));
+}
+
 bool HTLayoutLinear::should_manage_mouse() {
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
@@ -223,6 +237,18 @@ float HTLayoutLinear::drag_window_scale() {
     return 1;
 }
 
+void HTLayoutLinear::stop_animations() {
+    HTLayoutBase::stop_animations();
+    scroll_offset->resetAllCallbacks();
+    scroll_offset->warp();
+    view_offset->resetAllCallbacks();
+    view_offset->warp();
+    blur_strength->resetAllCallbacks();
+    blur_strength->warp();
+    dim_opacity->resetAllCallbacks();
+    dim_opacity->warp();
+}
+
 void HTLayoutLinear::init_position() {
     build_overview_layout(HT_VIEW_CLOSED);
 
@@ -259,6 +285,8 @@ CBox HTLayoutLinear::calculate_ws_box(int x, int y, HTViewStage stage) {
 }
 
 void HTLayoutLinear::build_overview_layout(HTViewStage stage) {
+    HT_TRACE_SCOPE("build_overview_layout", view_id);
+
     const PHLMONITOR monitor = get_monitor();
     if (monitor == nullptr)
         return;
@@ -273,6 +301,8 @@ void HTLayoutLinear::build_overview_layout(HTViewStage stage) {
             continue;
         if (workspace->m_isSpecialWorkspace)
             continue;
+        if (workspace_pool::is_parked(workspace))
+            continue;
         monitor_workspaces.push_back(workspace->m_id);
     }
     std::sort(monitor_workspaces.begin(), monitor_workspaces.end());
@@ -288,11 +318,16 @@ void HTLayoutLinear::build_overview_layout(HTViewStage stage) {
     }
 }
 
+bool HTLayoutLinear::is_animating() {
+    return HTLayoutBase::is_animating() || scroll_offset->isBeingAnimated() || view_offset->isBeingAnimated()
+        || blur_strength->isBeingAnimated() || dim_opacity->isBeingAnimated();
+}
+
 void HTLayoutLinear::render() {
     HTLayoutBase::render();
     CScopeGuard x([this] { post_render(); });
 
-    const PHTVIEW par_view = ht_manager->get_view_from_id(view_id);
+    const PHTVIEW& par_view = ht_manager->get_view_from_id(view_id);
     if (par_view == nullptr)
         return;
     const PHLMONITOR monitor = par_view->get_monitor();
@@ -310,7 +345,7 @@ void HTLayoutLinear::render() {
 
 	const auto time = Time::steadyNow();
 
-    g_pHyprRenderer->damageMonitor(monitor);
+    schedule_next_frame();
     g_pHyprOpenGL->m_renderData.pCurrentMonData->blurFBShouldRender = true;
 
     // Do a dance with active workspaces: Hyprland will only properly render the
@@ -394,6 +429,8 @@ void HTLayoutLinear::render() {
         if (global_box.intersection(global_mon_box).empty())
             continue;
 
+        HT_TRACE_SCOPE("render_tile", ws_id);
+
         const CGradientValueData border_col = workspace == big_ws ? *ACTIVECOL : *INACTIVECOL;
         CBox border_box = ws_layout.box;
 
@@ -438,6 +475,8 @@ void HTLayoutLinear::render() {
                 render_box
             );
         }
+
+        render_filter(ws_id, ws_layout.box);
     }
 
     monitor->m_activeWorkspace = start_workspace;
@@ -450,22 +489,5 @@ void HTLayoutLinear::render() {
     start_workspace->m_visible = true;
 
     // Render dragged window at mouse cursor
-    const PHTVIEW cursor_view = ht_manager->get_view_from_cursor();
-    if (cursor_view == nullptr)
-        return;
-
-    const SP<Layout::ITarget> target = g_layoutManager->dragController()->target();
-    if (target == nullptr)
-        return;
-
-    const PHLWINDOW dragged_window = target->window();
-    if (dragged_window == nullptr)
-        return;
-    const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
-    const CBox window_box = dragged_window->getWindowMainSurfaceBox()
-                                .translate(-mouse_coords)
-                                .scale(cursor_view->layout->drag_window_scale())
-                                .translate(mouse_coords);
-    if (!window_box.intersection(monitor->logicalBox()).empty())
-        render_window_at_box(dragged_window, monitor, time, window_box);
+    render_drag_preview(monitor, time);
 }
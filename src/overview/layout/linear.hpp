@@ -12,6 +12,9 @@ class HTLayoutLinear: public HTLayoutBase {
 
     bool rendering_standard_ws;
 
+    // Keep the strip's scroll offset inside its content
+    double clamp_scroll_offset(double new_offset);
+
   public:
     HTLayoutLinear(VIEWID view_id);
     virtual ~HTLayoutLinear() = default;
@@ -25,12 +28,15 @@ class HTLayoutLinear: public HTLayoutBase {
     virtual void on_hide(CallbackFun on_complete);
     virtual void on_move(WORKSPACEID old_id, WORKSPACEID new_id, CallbackFun on_complete);
 
-    virtual bool on_mouse_axis(double delta);
+    virtual bool on_mouse_axis(const HTAxisEvent& e);
+    virtual void on_pan(Vector2D delta);
 
     virtual bool should_manage_mouse();
     virtual bool should_render_window(PHLWINDOW window);
     virtual float drag_window_scale();
+    virtual void stop_animations();
     virtual void init_position();
     virtual void build_overview_layout(HTViewStage stage);
     virtual void render();
+    virtual bool is_animating();
 };
@@ -1,44 +1,101 @@
 #include "manager.hpp"
 
+#include <algorithm>
+
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/config/ConfigManager.hpp>
 #include <hyprland/src/desktop/DesktopTypes.hpp>
 #include <hyprland/src/managers/KeybindManager.hpp>
 #include <hyprland/src/managers/input/InputManager.hpp>
+#include <hyprland/src/render/Renderer.hpp>
 
 #include "overview.hpp"
 
+static const PHTVIEW null_view;
+
 HTManager::HTManager() {
     swipe_state = HT_SWIPE_NONE;
     swipe_amt = 0.0;
+    swipe_axis = 0;
+    swipe_velocity = {};
+    swipe_last_ms = 0;
+    touch_state = HT_TOUCH_NONE;
+    touch_pinch_start_dist = 0.0;
+    touch_pinch_perc = 1.f;
+    any_view_active = false;
 }
 
-PHTVIEW HTManager::get_view_from_monitor(PHLMONITOR monitor) {
+const PHTVIEW& HTManager::get_view_from_monitor(const PHLMONITOR& monitor) {
     if (monitor == nullptr)
-        return nullptr;
-    for (PHTVIEW view : views) {
-        if (view == nullptr)
-            continue;
-        if (view->get_monitor() != monitor)
-            continue;
-        return view;
-    }
-    return nullptr;
+        return null_view;
+    return get_view_from_id(monitor->m_id);
 }
 
-PHTVIEW HTManager::get_view_from_cursor() {
+const PHTVIEW& HTManager::get_view_from_cursor() {
     return get_view_from_monitor(g_pCompositor->getMonitorFromCursor());
 }
 
-PHTVIEW HTManager::get_view_from_id(VIEWID view_id) {
-    for (PHTVIEW view : views) {
-        if (view == nullptr)
-            continue;
-        if (view->monitor_id != view_id)
-            continue;
-        return view;
-    }
-    return nullptr;
+const PHTVIEW& HTManager::get_view_from_id(VIEWID view_id) {
+    const auto it = std::lower_bound(views.begin(), views.end(), view_id, [](const PHTVIEW& view, VIEWID id) {
+        return view->monitor_id < id;
+    });
+    if (it == views.end() || (*it)->monitor_id != view_id)
+        return null_view;
+    return *it;
+}
+
+void HTManager::add_view(const PHTVIEW& view) {
+    if (view == nullptr)
+        return;
+    const auto it = std::lower_bound(views.begin(), views.end(), view->monitor_id, [](const PHTVIEW& v, VIEWID id) {
+        return v->monitor_id < id;
+    });
+    views.insert(it, view);
+    update_active_state();
+}
+
+// Descriptions survive re-plugging, names and ids may not
+static std::string monitor_key(const PHLMONITOR& monitor) {
+    return monitor->m_description.empty() ? monitor->m_name : monitor->m_description;
+}
+
+void HTManager::remove_monitor(const PHLMONITOR& monitor) {
+    if (monitor == nullptr)
+        return;
+
+    const auto it = std::lower_bound(views.begin(), views.end(), monitor->m_id, [](const PHTVIEW& v, VIEWID id) {
+        return v->monitor_id < id;
+    });
+    if (it == views.end() || (*it)->monitor_id != monitor->m_id)
+        return;
+
+    const PHTVIEW view = *it;
+    views.erase(it);
+    view->detach();
+    update_active_state();
+
+    // Bounded, a dock that is never seen again shouldn't keep its view forever
+    constexpr size_t MAX_DETACHED_VIEWS = 8;
+    const std::string key = monitor_key(monitor);
+    std::erase_if(detached_views, [&key](const auto& entry) { return entry.first == key; });
+    if (detached_views.size() >= MAX_DETACHED_VIEWS)
+        detached_views.erase(detached_views.begin());
+    detached_views.emplace_back(key, view);
+}
+
+PHTVIEW HTManager::take_detached_view(const PHLMONITOR& monitor) {
+    if (monitor == nullptr)
+        return nullptr;
+
+    const std::string key = monitor_key(monitor);
+    const auto it = std::ranges::find(detached_views, key, &std::pair<std::string, PHTVIEW>::first);
+    if (it == detached_views.end())
+        return nullptr;
+
+    const PHTVIEW view = it->second;
+    detached_views.erase(it);
+    view->reattach(monitor->m_id);
+    return view;
 }
 
 PHLWINDOW HTManager::get_window_from_cursor(bool return_focused) {
@@ -49,25 +106,25 @@ PHLWINDOW HTManager::get_window_from_cursor(bool return_focused) {
     if (return_focused)
         return cursor_monitor->m_activeWorkspace->getLastFocusedWindow();
 
-    const PHTVIEW cursor_view = get_view_from_monitor(cursor_monitor);
+    const PHTVIEW& cursor_view = get_view_from_monitor(cursor_monitor);
     if (cursor_view == nullptr)
         return nullptr;
 
     const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
 
-    if (!cursor_view->active || !cursor_view->layout->should_manage_mouse()) {
+    if (!cursor_view->active || !cursor_view->get_layout()->should_manage_mouse()) {
         return g_pCompositor->vectorToWindowUnified(
             mouse_coords,
             Desktop::View::RESERVED_EXTENTS | Desktop::View::INPUT_EXTENTS | Desktop::View::ALLOW_FLOATING
         );
     }
 
-    const WORKSPACEID ws_id = cursor_view->layout->get_ws_id_from_global(mouse_coords);
+    const WORKSPACEID ws_id = cursor_view->get_layout()->get_ws_id_from_global(mouse_coords);
     const PHLWORKSPACE hovered_workspace = g_pCompositor->getWorkspaceByID(ws_id);
     if (hovered_workspace == nullptr)
         return nullptr;
 
-    const Vector2D ws_coords = cursor_view->layout->global_to_local_ws_unscaled(mouse_coords, ws_id)
+    const Vector2D ws_coords = cursor_view->get_layout()->global_to_local_ws_unscaled(mouse_coords, ws_id)
         + cursor_monitor->m_position;
 
     const PHLWORKSPACEREF o_workspace = cursor_monitor->m_activeWorkspace;
@@ -85,23 +142,17 @@ PHLWINDOW HTManager::get_window_from_cursor(bool return_focused) {
 }
 
 void HTManager::show_all_views() {
-    for (PHTVIEW view : views) {
-        if (view == nullptr)
-            continue;
+    for (const PHTVIEW& view : views)
         view->show();
-    }
 }
 
 void HTManager::hide_all_views() {
-    for (PHTVIEW view : views) {
-        if (view == nullptr)
-            continue;
+    for (const PHTVIEW& view : views)
         view->hide(false);
-    }
 }
 
 void HTManager::show_cursor_view() {
-    const PHTVIEW view = get_view_from_cursor();
+    const PHTVIEW& view = get_view_from_cursor();
     if (view != nullptr)
         view->show();
 }
@@ -109,21 +160,67 @@ void HTManager::show_cursor_view() {
 void HTManager::reset() {
     swipe_state = HT_SWIPE_NONE;
     swipe_amt = 0.0;
+    swipe_axis = 0;
+    swipe_velocity = {};
+    swipe_last_ms = 0;
+    touch_state = HT_TOUCH_NONE;
+    touch_points.clear();
+    touch_monitor.reset();
+    touch_pinch_start_dist = 0.0;
+    touch_pinch_perc = 1.f;
     views.clear();
+    detached_views.clear();
+    any_view_active = false;
+    search_index.clear();
+    filter_query.clear();
+    filter_results.clear();
+    cycle.reset();
+}
+
+void HTManager::update_active_state() {
+    any_view_active = std::ranges::any_of(views, [](const PHTVIEW& view) { return view->active; });
 }
 
 bool HTManager::has_active_view() {
-    for (const auto& view : views) {
-        if (view == nullptr)
+    return any_view_active;
+}
+
+bool HTManager::filter_active() {
+    return !filter_query.empty();
+}
+
+bool HTManager::filter_matches(const PHLWINDOW& window) {
+    return !filter_active() || filter_results.contains(window.get());
+}
+
+void HTManager::set_filter(const std::string& query) {
+    if (query == filter_query)
+        return;
+
+    const bool was_active = filter_active();
+    const auto old_results = std::move(filter_results);
+    filter_query = query;
+    filter_results = query.empty() ? std::unordered_set<const CWindow*> {} : search_index.query(query);
+
+    std::unordered_set<WORKSPACEID> damaged;
+    for (const auto& window : g_pCompositor->m_windows) {
+        if (!window->m_isMapped || window->m_workspace == nullptr)
+            continue;
+
+        const bool was_dimmed = was_active && !old_results.contains(window.get());
+        if (was_dimmed == !filter_matches(window) || !damaged.insert(window->m_workspace->m_id).second)
+            continue;
+
+        const PHTVIEW& view = get_view_from_monitor(window->m_monitor.lock());
+        if (view == nullptr || !view->active)
             continue;
-        if (view->active)
-            return true;
+        CBox box = view->get_layout()->get_global_ws_box(window->m_workspace->m_id);
+        g_pHyprRenderer->damageBox(box);
     }
-    return false;
 }
 
 bool HTManager::cursor_view_active() {
-    const PHTVIEW view = get_view_from_cursor();
+    const PHTVIEW& view = get_view_from_cursor();
     if (view == nullptr)
         return false;
     return view->active;
@@ -1,19 +1,30 @@
 #pragma once
 
 #include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <hyprland/src/devices/ITouch.hpp>
 #include <hyprland/src/helpers/AnimatedVariable.hpp>
 
+#include "cycle.hpp"
 #include "overview.hpp"
+#include "search.hpp"
 
 class HTManager {
   public:
     HTManager();
 
+    // Kept sorted by monitor_id so lookups are a binary search, only add through add_view
     std::vector<PHTVIEW> views;
 
-    PHTVIEW get_view_from_monitor(PHLMONITOR pMonitor);
-    PHTVIEW get_view_from_cursor();
-    PHTVIEW get_view_from_id(VIEWID view_id);
+    // Lookups return a reference into views (or to a null view) to avoid refcount churn in hot paths
+    const PHTVIEW& get_view_from_monitor(const PHLMONITOR& pMonitor);
+    const PHTVIEW& get_view_from_cursor();
+    const PHTVIEW& get_view_from_id(VIEWID view_id);
+
+    void add_view(const PHTVIEW& view);
+    // Detach the view of a removed monitor and keep it, keyed by the monitor's description
+    void remove_monitor(const PHLMONITOR& monitor);
+    // The cached view of a monitor that was plugged in before, reattached to its new id, or nullptr
+    PHTVIEW take_detached_view(const PHLMONITOR& monitor);
 
     PHLWINDOW get_window_from_cursor(bool return_focused = true);
 
@@ -27,7 +38,7 @@ class HTManager {
     bool end_window_drag();
     bool exit_to_workspace();
     bool on_mouse_move();
-    bool on_mouse_axis(double delta);
+    bool on_mouse_axis(const IPointer::SAxisEvent& e);
 
     enum swipe_state_t {
         HT_SWIPE_OPEN,
@@ -37,10 +48,61 @@ class HTManager {
 
     swipe_state_t swipe_state;
     float swipe_amt;
+    // A move swipe is locked to the axis ('h' or 'v') of its first update
+    char swipe_axis;
+    // Smoothed finger velocity in swipe units per ms, used to predict flicks
+    Vector2D swipe_velocity;
+    uint32_t swipe_last_ms;
     void swipe_start();
     bool swipe_update(IPointer::SSwipeUpdateEvent e);
-    bool swipe_end();
+    bool swipe_end(uint32_t time_ms);
+
+    enum touch_state_t {
+        HT_TOUCH_NONE,
+        HT_TOUCH_TAP,
+        HT_TOUCH_DRAG,
+        HT_TOUCH_PAN,
+        HT_TOUCH_PINCH,
+    };
+
+    struct HTTouchPoint {
+        int32_t id;
+        // Global layout coordinates
+        Vector2D start_pos;
+        Vector2D pos;
+        uint32_t down_ms;
+    };
 
+    // Touch is handled as events arrive, a gesture is owned by the monitor of its first touch point
+    touch_state_t touch_state;
+    std::vector<HTTouchPoint> touch_points;
+    PHLMONITORREF touch_monitor;
+    double touch_pinch_start_dist;
+    float touch_pinch_perc;
+    bool touch_down(ITouch::SDownEvent e);
+    bool touch_up(ITouch::SUpEvent e);
+    bool touch_motion(ITouch::SMotionEvent e);
+
+    HTSearchIndex search_index;
+    // Type-to-filter while the overview is open, empty when not filtering
+    std::string filter_query;
+    bool filter_active();
+    // False if the current filter dims window
+    bool filter_matches(const PHLWINDOW& window);
+    // Only damages the tiles whose windows changed between dimmed and not
+    void set_filter(const std::string& query);
+
+    // hyprtile:cycle and the MRU ring it walks
+    HTCycle cycle;
+
+    // Must be called whenever a view's active flag changes
+    void update_active_state();
     bool has_active_view();
     bool cursor_view_active();
+
+  private:
+    bool any_view_active;
+    std::unordered_set<const CWindow*> filter_results;
+    // Views of unplugged monitors, most recent last
+    std::vector<std::pair<std::string, PHTVIEW>> detached_views;
 };
@@ -11,20 +11,32 @@
 #include <hyprland/src/desktop/state/FocusState.hpp>
 #include <hyprutils/math/Box.hpp>
 
+#include "../event_socket.h"
+#include "../replay.h"
 #include "config.hpp"
 #include "globals.hpp"
 #include "layout/column.hpp"
 #include "layout/grid.hpp"
 #include "layout/linear.hpp"
 
-HTView::HTView(MONITORID in_monitor_id)
+HTView::HTView(MONITORID in_monitor_id) : thumbnails(in_monitor_id)
 {
     monitor_id = in_monitor_id;
     active = false;
     closing = false;
     navigating = false;
+}
 
-    change_layout(HTConfig::value<Hyprlang::STRING>("layout"));
+const SP<HTLayoutBase> &HTView::get_layout()
+{
+    if (layout == nullptr)
+        change_layout(HTConfig::value<Hyprlang::STRING>("layout"));
+    return layout;
+}
+
+bool HTView::has_layout() const
+{
+    return layout != nullptr;
 }
 
 void HTView::change_layout(const std::string &layout_name)
@@ -65,7 +77,7 @@ void HTView::do_exit_behavior(bool exit_on_mouse)
             return WORKSPACE_INVALID;
 
         const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
-        return layout->get_ws_id_from_global(mouse_coords);
+        return get_layout()->get_ws_id_from_global(mouse_coords);
     };
 
     const int EXIT_ON_HOVERED = HTConfig::value<Hyprlang::INT>("exit_on_hovered");
@@ -107,11 +119,18 @@ void HTView::show()
     if (active_workspace == nullptr)
         return;
 
+    // While any overview is open the render hooks ask every view's layout, build them here instead of in a frame
+    for (const PHTVIEW &view : ht_manager->views)
+        view->get_layout();
+
     active = true;
     closing = false;
     navigating = false;
+    ht_manager->update_active_state();
 
     layout->on_show();
+    event_socket::post("overviewopened", monitor->m_name);
+    replay::record_marker("overview_open", monitor->m_name);
 
     // Preserve workspaces after layout is built to prevent them from being destroyed
     // when windows are moved away during overview mode
@@ -119,8 +138,8 @@ void HTView::show()
 
     Cursor::overrideController->setOverride("left_ptr", Cursor::CURSOR_OVERRIDE_UNKNOWN);
 
+    // The first frame of the animation, the layout asks for the rest while it runs
     g_pHyprRenderer->damageMonitor(monitor);
-    g_pCompositor->scheduleFrameForMonitor(monitor);
 }
 
 void HTView::hide(bool exit_on_mouse)
@@ -133,24 +152,64 @@ void HTView::hide(bool exit_on_mouse)
         return;
 
     do_exit_behavior(exit_on_mouse);
+    ht_manager->set_filter("");
 
     active = true;
     closing = true;
     navigating = false;
+    ht_manager->update_active_state();
+
+    event_socket::post("overviewclosed", monitor->m_name);
+    replay::record_marker("overview_close", monitor->m_name);
 
-    layout->on_hide([this](auto self) {
+    get_layout()->on_hide([this](auto self) {
         active = false;
         closing = false;
+        ht_manager->update_active_state();
 
         // Release workspace preservation when the overview animation completes
         // Empty workspaces will be destroyed automatically after this
         release_workspaces();
+
+        // One more frame so the workspace is drawn by Hyprland again instead of the layout
+        const PHLMONITOR monitor = get_monitor();
+        if (monitor != nullptr)
+            g_pHyprRenderer->damageMonitor(monitor);
     });
 
     Cursor::overrideController->unsetOverride(Cursor::CURSOR_OVERRIDE_UNKNOWN);
 
     g_pHyprRenderer->damageMonitor(monitor);
-    g_pCompositor->scheduleFrameForMonitor(monitor);
+}
+
+void HTView::detach()
+{
+    // No exit behaviour or hide animation, there is nothing left to show them on
+    if (active)
+    {
+        Cursor::overrideController->unsetOverride(Cursor::CURSOR_OVERRIDE_UNKNOWN);
+        const PHLMONITOR monitor = get_monitor();
+        if (!closing && monitor != nullptr)
+            event_socket::post("overviewclosed", monitor->m_name);
+    }
+    active = false;
+    closing = false;
+    navigating = false;
+
+    if (layout != nullptr)
+        layout->stop_animations();
+    thumbnails.clear();
+    release_workspaces();
+}
+
+void HTView::reattach(MONITORID new_monitor_id)
+{
+    monitor_id = new_monitor_id;
+    thumbnails.set_monitor_id(new_monitor_id);
+    if (layout == nullptr)
+        return;
+    layout->set_view_id(new_monitor_id);
+    layout->init_position();
 }
 
 void HTView::warp_window(Hyprlang::INT warp, PHLWINDOW window)
@@ -208,7 +267,38 @@ void HTView::move_id(WORKSPACEID ws_id, bool move_window)
     warp_window(warp, hovered_window);
 
     navigating = true;
-    layout->on_move(active_workspace->m_id, other_workspace->m_id, [this](auto self) { navigating = false; });
+    get_layout()->on_move(active_workspace->m_id, other_workspace->m_id, [this](auto self) {
+        navigating = false;
+        prefetch_neighbours();
+
+        const PHLMONITOR monitor = get_monitor();
+        if (monitor != nullptr)
+            g_pHyprRenderer->damageMonitor(monitor);
+    });
+    g_pHyprRenderer->damageMonitor(monitor);
+}
+
+void HTView::prefetch_neighbours()
+{
+    if (active)
+        return;
+    const PHLMONITOR monitor = get_monitor();
+    if (monitor == nullptr || monitor->m_activeWorkspace == nullptr)
+        return;
+
+    get_layout()->build_overview_layout(HT_VIEW_CLOSED);
+    const auto it = get_layout()->overview_layout.find(monitor->m_activeWorkspace->m_id);
+    if (it == get_layout()->overview_layout.end())
+        return;
+
+    std::vector<WORKSPACEID> ws_ids;
+    for (std::string direction : {"left", "right", "up", "down"})
+    {
+        const WORKSPACEID ws_id = get_layout()->get_ws_id_in_direction(it->second.x, it->second.y, direction);
+        if (ws_id != WORKSPACE_INVALID && g_pCompositor->getWorkspaceByID(ws_id) != nullptr)
+            ws_ids.push_back(ws_id);
+    }
+    thumbnails.prefetch(ws_ids);
 }
 
 void HTView::move(std::string arg, bool move_window)
@@ -226,9 +316,9 @@ void HTView::move(std::string arg, bool move_window)
     // if moving a window, the up/down/left/right should be relative to the window (and cursor) and not necessarily the
     // active workspace
     const WORKSPACEID source_ws_id = move_window ? hovered_window->workspaceID() : active_workspace->m_id;
-    layout->build_overview_layout(HT_VIEW_CLOSED);
-    const auto ws_layout = layout->overview_layout[source_ws_id];
-    const WORKSPACEID id = layout->get_ws_id_in_direction(ws_layout.x, ws_layout.y, arg);
+    get_layout()->build_overview_layout(HT_VIEW_CLOSED);
+    const auto ws_layout = get_layout()->overview_layout[source_ws_id];
+    const WORKSPACEID id = get_layout()->get_ws_id_in_direction(ws_layout.x, ws_layout.y, arg);
 
     move_id(id, move_window);
 }
@@ -247,7 +337,7 @@ void HTView::preserve_workspaces()
 
     // Hold references to all workspaces currently in the overview layout.
     // This prevents Hyprland from destroying empty workspaces during overview mode.
-    for (const auto &[ws_id, ws_layout] : layout->overview_layout)
+    for (const auto &[ws_id, ws_layout] : get_layout()->overview_layout)
     {
         PHLWORKSPACE ws = g_pCompositor->getWorkspaceByID(ws_id);
         if (ws != nullptr)
@@ -9,6 +9,7 @@
 #include <hyprutils/math/Vector2D.hpp>
 
 #include "layout/layout_base.hpp"
+#include "thumbnails.hpp"
 
 typedef long VIEWID;
 
@@ -24,7 +25,14 @@ class HTView {
 
     MONITORID monitor_id;
 
-    SP<HTLayoutBase> layout;
+    // The layout is only built on first use, so loading the plugin doesn't set up layouts and their animated
+    // variables for monitors the overview is never opened on
+    const SP<HTLayoutBase>& get_layout();
+    bool has_layout() const;
+
+    HTThumbnailCache thumbnails;
+    // Snapshot the workspaces next to the active one so a following move starts warm
+    void prefetch_neighbours();
 
     void do_exit_behavior(bool exit_on_mouse);
     void warp_window(Hyprlang::INT warp, PHLWINDOW window);
@@ -34,11 +42,18 @@ class HTView {
     void show();
     void hide(bool exit_on_mouse);
 
+    // The monitor went away: drop transient overview state so the view can be cached and reattached
+    void detach();
+    // Reuse this view for a re-plugged monitor with a new id
+    void reattach(MONITORID new_monitor_id);
+
     void move_id(WORKSPACEID ws_id, bool move_window);
     // arg is up, down, left, right;
     void move(std::string arg, bool move_window);
 
   private:
+    SP<HTLayoutBase> layout;
+
     // Hold references to workspaces during overview to prevent them from being destroyed
     std::vector<PHLWORKSPACE> preserved_workspaces;
 
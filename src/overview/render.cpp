@@ -1,15 +1,24 @@
 #include "render.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <wayland-server-core.h>
+
 #include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/config/ConfigValue.hpp>
 #include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <hyprland/src/layout/LayoutManager.hpp>
 #include <hyprland/src/managers/input/InputManager.hpp>
 #include <hyprland/src/render/OpenGL.hpp>
 #include <hyprland/src/render/Renderer.hpp>
+#include <hyprland/src/protocols/core/Compositor.hpp>
+#include <hyprland/src/render/Framebuffer.hpp>
 #include <hyprland/src/render/pass/RendererHintsPassElement.hpp>
+#include <hyprland/src/render/pass/TexPassElement.hpp>
 #include <hyprutils/math/Vector2D.hpp>
 
 #include "globals.hpp"
+#include "overview.hpp"
 #include "types.hpp"
 
 // Note: box is relative to (0, 0), not monitor
@@ -48,3 +57,153 @@ void render_window_at_box(PHLWINDOW window, PHLMONITOR monitor, const Time::stea
         CRendererHintsPassElement::SData {SRenderModifData {}}
     ));
 }
+
+bool capture_window(PHLWINDOW window, HTWindowCapture& capture, const Vector2D& max_size) {
+    if (window == nullptr)
+        return false;
+    const PHLMONITOR monitor = window->m_monitor.lock();
+    if (monitor == nullptr)
+        return false;
+
+    const Vector2D window_size = window->m_realSize->value();
+    if (window_size.x <= 0 || window_size.y <= 0)
+        return false;
+
+    double scale = 1.0;
+    if (max_size.x > 0 && max_size.y > 0)
+        scale = std::min({1.0, max_size.x / window_size.x, max_size.y / window_size.y});
+
+    // The window is rendered at the top left of the monitor, anything of it past the framebuffer is clipped
+    const Vector2D fb_size = {
+        std::clamp(std::ceil(window_size.x * scale * monitor->m_scale), 1.0, monitor->m_pixelSize.x),
+        std::clamp(std::ceil(window_size.y * scale * monitor->m_scale), 1.0, monitor->m_pixelSize.y)
+    };
+
+    if (capture.fb == nullptr)
+        capture.fb = makeUnique<CFramebuffer>();
+    if (capture.fb->m_size != fb_size)
+        capture.fb->alloc(fb_size.x, fb_size.y, monitor->m_output->state->state().drmFormat);
+
+    CRegion fake_damage {0, 0, INT16_MAX, INT16_MAX};
+    g_pHyprRenderer->beginRender(monitor, fake_damage, RENDER_MODE_FULL_FAKE, nullptr, capture.fb.get());
+    g_pHyprOpenGL->clear(CHyprColor {0, 0, 0, 0});
+    if (scale < 1.0) {
+        SRenderModifData data {};
+        data.modifs.push_back({SRenderModifData::eRenderModifType::RMOD_TYPE_SCALE, (float)scale});
+        g_pHyprRenderer->m_renderPass.add(
+            makeUnique<CRendererHintsPassElement>(CRendererHintsPassElement::SData {data})
+        );
+    }
+    ((render_window_t)render_window)(
+        g_pHyprRenderer.get(),
+        window,
+        monitor,
+        Time::steadyNow(),
+        false,
+        RENDER_PASS_MAIN,
+        true,
+        true
+    );
+    if (scale < 1.0)
+        g_pHyprRenderer->m_renderPass.add(makeUnique<CRendererHintsPassElement>(
+            CRendererHintsPassElement::SData {SRenderModifData {}}
+        ));
+    g_pHyprOpenGL->m_renderData.blockScreenShader = true;
+    g_pHyprRenderer->endRender();
+
+    capture.window_size = window_size * scale;
+    capture.size = fb_size / monitor->m_scale;
+    return true;
+}
+
+void render_window_capture(const HTWindowCapture& capture, PHLMONITOR monitor, const CBox& box) {
+    if (capture.fb == nullptr || capture.window_size.x <= 0 || monitor == nullptr)
+        return;
+
+    // A plain textured quad: the whole capture scaled so the window inside it covers box
+    const double preview_scale = box.w / capture.window_size.x;
+    CTexPassElement::SRenderData data;
+    data.tex = capture.fb->getTexture();
+    data.box = {
+        (box.pos() - monitor->m_position) * monitor->m_scale,
+        capture.size * preview_scale * monitor->m_scale
+    };
+    g_pHyprRenderer->m_renderPass.add(makeUnique<CTexPassElement>(data));
+}
+
+static struct {
+    PHLWINDOWREF window;
+    HTWindowCapture capture;
+    CHyprSignalListener commit_listener;
+    wl_event_source* idle_source = nullptr;
+} drag_preview;
+
+static void capture_drag_preview() {
+    capture_window(drag_preview.window.lock(), drag_preview.capture);
+}
+
+void begin_drag_preview(PHLWINDOW window) {
+    end_drag_preview();
+    if (window == nullptr)
+        return;
+
+    drag_preview.window = window;
+    capture_drag_preview();
+
+    // Re-capture after the client commits, from the event loop so it never lands inside a frame
+    const auto surface = window->wlSurface() ? window->wlSurface()->resource() : nullptr;
+    if (surface == nullptr)
+        return;
+    drag_preview.commit_listener = surface->m_events.commit.listen([] {
+        if (drag_preview.idle_source != nullptr)
+            return;
+        drag_preview.idle_source = wl_event_loop_add_idle(
+            g_pCompositor->m_wlEventLoop,
+            [](void* data) {
+                drag_preview.idle_source = nullptr;
+                capture_drag_preview();
+            },
+            nullptr
+        );
+    });
+}
+
+void end_drag_preview() {
+    if (drag_preview.idle_source != nullptr) {
+        wl_event_source_remove(drag_preview.idle_source);
+        drag_preview.idle_source = nullptr;
+    }
+    drag_preview.commit_listener.reset();
+    drag_preview.window.reset();
+    drag_preview.capture = {};
+}
+
+void render_drag_preview(PHLMONITOR monitor, const Time::steady_tp& time) {
+    // The preview is scaled like the tile under the cursor, even when drawn on another monitor
+    const PHTVIEW& cursor_view = ht_manager->get_view_from_cursor();
+    if (cursor_view == nullptr || monitor == nullptr)
+        return;
+
+    const SP<Layout::ITarget> target = g_layoutManager->dragController()->target();
+    if (target == nullptr)
+        return;
+    const PHLWINDOW dragged_window = target->window();
+    if (dragged_window == nullptr)
+        return;
+
+    const Vector2D mouse_coords = g_pInputManager->getMouseCoordsInternal();
+    const CBox window_box = dragged_window->getWindowMainSurfaceBox()
+                                .translate(-mouse_coords)
+                                .scale(cursor_view->get_layout()->drag_window_scale())
+                                .translate(mouse_coords);
+    if (window_box.intersection(monitor->logicalBox()).empty())
+        return;
+
+    if (drag_preview.window.lock() != dragged_window || drag_preview.capture.fb == nullptr
+        || drag_preview.capture.window_size.x <= 0) {
+        render_window_at_box(dragged_window, monitor, time, window_box);
+        return;
+    }
+
+    render_window_capture(drag_preview.capture, monitor, window_box);
+}
@@ -3,6 +3,27 @@
 #include <hyprland/src/desktop/DesktopTypes.hpp>
 #include <hyprland/src/plugins/PluginAPI.hpp>
 #include <hyprland/src/helpers/time/Time.hpp>
+#include <hyprland/src/render/Framebuffer.hpp>
 #include <hyprutils/math/Box.hpp>
 
 void render_window_at_box(PHLWINDOW window, PHLMONITOR monitor, const Time::steady_tp& time, CBox box);
+
+// A window rendered alone into a texture just big enough for it, at the scale of the monitor it was captured on.
+// Sizes are logical: window_size is the window as drawn in the texture, size the whole texture
+struct HTWindowCapture {
+    UP<CFramebuffer> fb;
+    Vector2D window_size;
+    Vector2D size;
+};
+
+// Never call from inside a frame, captures go through their own render pass. With a max_size the window is
+// downscaled to fit it, so small previews don't hold full resolution textures
+bool capture_window(PHLWINDOW window, HTWindowCapture& capture, const Vector2D& max_size = {});
+// Draw the capture so the window inside it covers box, which is relative to (0, 0) like render_window_at_box
+void render_window_capture(const HTWindowCapture& capture, PHLMONITOR monitor, const CBox& box);
+
+// Capture the dragged window once into a texture, refreshed only when the client commits
+void begin_drag_preview(PHLWINDOW window);
+void end_drag_preview();
+// Render the window being dragged in the overview about the cursor, on any monitor it overlaps
+void render_drag_preview(PHLMONITOR monitor, const Time::steady_tp& time);
@@ -0,0 +1,99 @@
+#include "search.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+#include <hyprland/src/desktop/view/Window.hpp>
+
+static std::string to_lower(std::string str) {
+    std::ranges::transform(str, str.begin(), [](unsigned char c) { return std::tolower(c); });
+    return str;
+}
+
+// Distinct trigrams of text, sorted
+static std::vector<uint32_t> get_trigrams(const std::string& text) {
+    std::vector<uint32_t> trigrams;
+    for (size_t i = 0; i + 3 <= text.size(); i++) {
+        trigrams.push_back(
+            ((uint32_t)(unsigned char)text[i] << 16) | ((uint32_t)(unsigned char)text[i + 1] << 8)
+            | (uint32_t)(unsigned char)text[i + 2]
+        );
+    }
+    std::ranges::sort(trigrams);
+    const auto [first, last] = std::ranges::unique(trigrams);
+    trigrams.erase(first, last);
+    return trigrams;
+}
+
+void HTSearchIndex::update(const PHLWINDOW& window) {
+    if (window == nullptr)
+        return;
+
+    // class and title on one line, the separator keeps trigrams from spanning both
+    std::string text = to_lower(window->m_class + "\n" + window->m_title);
+
+    const auto it = entries.find(window.get());
+    if (it != entries.end() && it->second.text == text)
+        return;
+    remove(window);
+
+    HTSearchEntry& entry = entries[window.get()];
+    entry.window = window;
+    entry.text = std::move(text);
+    entry.trigrams = get_trigrams(entry.text);
+    for (const uint32_t trigram : entry.trigrams)
+        postings[trigram].push_back(window.get());
+}
+
+void HTSearchIndex::remove(const PHLWINDOW& window) {
+    const auto it = entries.find(window.get());
+    if (it == entries.end())
+        return;
+
+    for (const uint32_t trigram : it->second.trigrams) {
+        auto posting = postings.find(trigram);
+        if (posting == postings.end())
+            continue;
+        std::erase(posting->second, window.get());
+        if (posting->second.empty())
+            postings.erase(posting);
+    }
+    entries.erase(it);
+}
+
+void HTSearchIndex::clear() {
+    entries.clear();
+    postings.clear();
+}
+
+std::unordered_set<const CWindow*> HTSearchIndex::query(const std::string& query) const {
+    std::unordered_set<const CWindow*> result;
+    const std::string needle = to_lower(query);
+
+    auto check = [&](const CWindow* window) {
+        const auto it = entries.find(window);
+        if (it != entries.end() && !it->second.window.expired() && it->second.text.contains(needle))
+            result.insert(window);
+    };
+
+    // too short for a trigram, there are few enough windows to check them all
+    if (needle.size() < 3) {
+        for (const auto& [window, entry] : entries)
+            check(window);
+        return result;
+    }
+
+    // Only windows in the shortest posting list of the query's trigrams can match
+    const std::vector<const CWindow*>* candidates = nullptr;
+    for (const uint32_t trigram : get_trigrams(needle)) {
+        const auto posting = postings.find(trigram);
+        if (posting == postings.end())
+            return result;
+        if (candidates == nullptr || posting->second.size() < candidates->size())
+            candidates = &posting->second;
+    }
+
+    for (const CWindow* window : *candidates)
+        check(window);
+    return result;
+}
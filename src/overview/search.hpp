@@ -0,0 +1,29 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Trigram index over window classes and titles for the overview's type-to-filter, kept up to date as windows
+// open, close and change title so a keystroke never rescans every window
+class HTSearchIndex {
+  public:
+    void update(const PHLWINDOW& window);
+    void remove(const PHLWINDOW& window);
+    void clear();
+
+    // Windows whose class or title contains query, case insensitive
+    std::unordered_set<const CWindow*> query(const std::string& query) const;
+
+  private:
+    struct HTSearchEntry {
+        PHLWINDOWREF window;
+        std::string text;
+        std::vector<uint32_t> trigrams;
+    };
+
+    std::unordered_map<const CWindow*, HTSearchEntry> entries;
+    std::unordered_map<uint32_t, std::vector<const CWindow*>> postings;
+};
@@ -0,0 +1,142 @@
+#include "thumbnails.hpp"
+
+#include <algorithm>
+
+#include <wayland-server-core.h>
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <hyprland/src/managers/animation/DesktopAnimationManager.hpp>
+#include <hyprland/src/render/OpenGL.hpp>
+#include <hyprland/src/render/Renderer.hpp>
+
+#include "../trace.h"
+#include "config.hpp"
+#include "globals.hpp"
+#include "types.hpp"
+
+HTThumbnailCache::HTThumbnailCache(MONITORID new_monitor_id) : monitor_id(new_monitor_id) {
+    ;
+}
+
+HTThumbnailCache::~HTThumbnailCache() {
+    if (idle_source != nullptr)
+        wl_event_source_remove(idle_source);
+}
+
+void HTThumbnailCache::prefetch(const std::vector<WORKSPACEID>& ws_ids) {
+    if (!HTConfig::value<Hyprlang::INT>("prefetch")) {
+        clear();
+        return;
+    }
+
+    // Keep the framebuffers of workspaces that stay in the set, they only need a refresh
+    std::erase_if(thumbnails, [&ws_ids](const UP<HTThumbnail>& thumbnail) {
+        return std::ranges::find(ws_ids, thumbnail->ws_id) == ws_ids.end();
+    });
+    for (const WORKSPACEID ws_id : ws_ids) {
+        if (std::ranges::none_of(thumbnails, [ws_id](const auto& thumbnail) { return thumbnail->ws_id == ws_id; }))
+            thumbnails.emplace_back(makeUnique<HTThumbnail>(ws_id));
+    }
+
+    if (thumbnails.empty() || idle_source != nullptr)
+        return;
+
+    idle_source = wl_event_loop_add_idle(
+        g_pCompositor->m_wlEventLoop,
+        [](void* data) {
+            auto* self = (HTThumbnailCache*)data;
+            self->idle_source = nullptr;
+            self->capture_all();
+        },
+        this
+    );
+}
+
+SP<CTexture> HTThumbnailCache::get(WORKSPACEID ws_id) {
+    const auto MAX_AGE = std::chrono::milliseconds(HTConfig::value<Hyprlang::INT>("prefetch_max_age"));
+    for (const auto& thumbnail : thumbnails) {
+        if (thumbnail->ws_id != ws_id)
+            continue;
+        if (!thumbnail->valid || Time::steadyNow() - thumbnail->captured > MAX_AGE)
+            return nullptr;
+        return thumbnail->fb.getTexture();
+    }
+    return nullptr;
+}
+
+void HTThumbnailCache::clear() {
+    if (idle_source != nullptr) {
+        wl_event_source_remove(idle_source);
+        idle_source = nullptr;
+    }
+    thumbnails.clear();
+}
+
+void HTThumbnailCache::set_monitor_id(MONITORID new_monitor_id) {
+    clear();
+    monitor_id = new_monitor_id;
+}
+
+void HTThumbnailCache::capture_all() {
+    HT_TRACE_SCOPE("prefetch_thumbnails", monitor_id);
+
+    const PHLMONITOR monitor = g_pCompositor->getMonitorFromID(monitor_id);
+    if (monitor == nullptr || monitor->m_activeWorkspace == nullptr)
+        return;
+
+    for (const auto& thumbnail : thumbnails)
+        capture(monitor, *thumbnail);
+}
+
+void HTThumbnailCache::capture(const PHLMONITOR& monitor, HTThumbnail& thumbnail) {
+    const PHLWORKSPACE workspace = g_pCompositor->getWorkspaceByID(thumbnail.ws_id);
+    if (workspace == nullptr || workspace->m_monitor != monitor) {
+        thumbnail.valid = false;
+        return;
+    }
+
+    const CBox monitor_box = {{0, 0}, monitor->m_pixelSize};
+    if (thumbnail.fb.m_size != monitor->m_pixelSize)
+        thumbnail.fb.alloc(monitor_box.w, monitor_box.h, monitor->m_output->state->state().drmFormat);
+
+    CRegion fake_damage {0, 0, INT16_MAX, INT16_MAX};
+    g_pHyprRenderer->beginRender(monitor, fake_damage, RENDER_MODE_FULL_FAKE, nullptr, &thumbnail.fb);
+    g_pHyprOpenGL->clear(CHyprColor {0, 0, 0, 1.0});
+
+    // Same dance as the layouts: Hyprland only renders the active workspace properly
+    const PHLWORKSPACE start_workspace = monitor->m_activeWorkspace;
+    start_workspace->m_visible = false;
+    monitor->m_activeWorkspace = workspace;
+    g_pDesktopAnimationManager->startAnimation(
+        workspace,
+        CDesktopAnimationManager::ANIMATION_TYPE_IN,
+        false,
+        true
+    );
+    workspace->m_visible = true;
+
+    ((render_workspace_t)(render_workspace_hook->m_original))(
+        g_pHyprRenderer.get(),
+        monitor,
+        workspace,
+        Time::steadyNow(),
+        monitor_box
+    );
+
+    g_pDesktopAnimationManager->startAnimation(
+        workspace,
+        CDesktopAnimationManager::ANIMATION_TYPE_OUT,
+        false,
+        true
+    );
+    workspace->m_visible = false;
+    monitor->m_activeWorkspace = start_workspace;
+    start_workspace->m_visible = true;
+
+    g_pHyprOpenGL->m_renderData.blockScreenShader = true;
+    g_pHyprRenderer->endRender();
+
+    thumbnail.captured = Time::steadyNow();
+    thumbnail.valid = true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+#include <hyprland/src/helpers/time/Time.hpp>
+#include <hyprland/src/render/Framebuffer.hpp>
+#include <hyprland/src/render/Texture.hpp>
+#include <vector>
+
+struct wl_event_source;
+
+// Offscreen snapshots of the workspaces a view is likely to move to next, so the first frames of a move don't
+// have to render them cold. Captures happen from the event loop, never inside a frame.
+class HTThumbnailCache {
+  public:
+    HTThumbnailCache(MONITORID monitor_id);
+    ~HTThumbnailCache();
+
+    HTThumbnailCache(const HTThumbnailCache&) = delete;
+    HTThumbnailCache& operator=(const HTThumbnailCache&) = delete;
+
+    // Replace the prefetched set with ws_ids, captured on the next event loop iteration
+    void prefetch(const std::vector<WORKSPACEID>& ws_ids);
+    // Snapshot of ws_id if it is younger than prefetch_max_age, nullptr otherwise
+    SP<CTexture> get(WORKSPACEID ws_id);
+    void clear();
+    // The monitor is re-plugged under a new id, snapshots of the old one are dropped
+    void set_monitor_id(MONITORID new_monitor_id);
+
+  private:
+    struct HTThumbnail {
+        WORKSPACEID ws_id;
+        CFramebuffer fb;
+        Time::steady_tp captured;
+        bool valid = false;
+    };
+
+    MONITORID monitor_id;
+    std::vector<UP<HTThumbnail>> thumbnails;
+    wl_event_source* idle_source = nullptr;
+
+    void capture_all();
+    void capture(const PHLMONITOR& monitor, HTThumbnail& thumbnail);
+};
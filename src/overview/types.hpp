@@ -26,4 +26,15 @@ typedef void (*render_window_t)(
     bool ignoreAllGeometry
 );
 
+typedef bool (*add_damage_box_t)(void* thisptr, const CBox& box);
+typedef bool (*add_damage_region_t)(void* thisptr, const CRegion& region);
+
 typedef long VIEWID;
+
+// Scroll input handed to the layouts, delta is in the axis' own units
+struct HTAxisEvent {
+    Vector2D delta;
+    // Touchpad and other smooth sources, which end with a zero delta when the fingers lift
+    bool continuous;
+    uint32_t time_ms;
+};
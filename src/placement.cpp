@@ -0,0 +1,324 @@
+#include "placement.h"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/debug/log/Logger.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprland/src/event/EventBus.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+#include <hyprlang.hpp>
+#include <hyprutils/string/String.hpp>
+#include <hyprutils/string/VarList.hpp>
+#include <re2/re2.h>
+#include <re2/set.h>
+
+#include <algorithm>
+#include <any>
+#include <climits>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "globals.h"
+#include "session.h"
+#include "topology.h"
+#include "utils.h"
+
+namespace placement
+{
+
+enum eRow
+{
+    ROW_INDEX,
+    ROW_NEXT_FREE,
+    ROW_SAME_AS_PARENT,
+};
+
+struct SCondition
+{
+    std::string pattern;
+    // plain strings are looked up in a hash table instead of going through the regex set
+    bool exact = false;
+};
+
+struct SRule
+{
+    int column = 0;
+    eRow row_type = ROW_INDEX;
+    int row = 0;
+    std::optional<SCondition> window_class;
+    std::optional<SCondition> title;
+};
+
+// Rules of one config generation, compiled into lookups that don't depend on the number of rules
+struct SMatcher
+{
+    std::vector<SRule> rules;
+
+    std::unordered_map<std::string, std::vector<size_t>> exact_class;
+    std::unordered_map<std::string, std::vector<size_t>> exact_title;
+
+    std::unique_ptr<RE2::Set> class_set;
+    std::unique_ptr<RE2::Set> title_set;
+    // regex set index -> rule index
+    std::vector<size_t> class_set_rules;
+    std::vector<size_t> title_set_rules;
+};
+
+// collected by the keyword handler while the config is parsed, compiled once it is done
+static std::vector<SRule> parsed_rules;
+static SMatcher matcher;
+static std::vector<std::any> listeners;
+
+static bool is_plain(const std::string &pattern)
+{
+    return std::ranges::none_of(pattern, [](char c) { return std::string_view("\\^$.|?*+()[]{}").contains(c); });
+}
+
+static Hyprlang::CParseResult on_rule_keyword(const char *command, const char *value)
+{
+    Hyprlang::CParseResult result;
+    Hyprutils::String::CVarList args(value, 0, ',', true);
+
+    if (args.size() < 3)
+    {
+        result.setError("hyprtile rule needs a column, a row and at least one of class: or title:");
+        return result;
+    }
+
+    SRule rule;
+    try
+    {
+        rule.column = std::stoi(args[0]);
+    }
+    catch (...)
+    {
+        result.setError("hyprtile rule: invalid column");
+        return result;
+    }
+
+    if (args[1] == "next-free")
+        rule.row_type = ROW_NEXT_FREE;
+    else if (args[1] == "same-as-parent")
+        rule.row_type = ROW_SAME_AS_PARENT;
+    else
+    {
+        try
+        {
+            rule.row = std::max(0, std::stoi(args[1]));
+        }
+        catch (...)
+        {
+            result.setError("hyprtile rule: row must be a number, next-free or same-as-parent");
+            return result;
+        }
+    }
+
+    for (size_t i = 2; i < args.size(); ++i)
+    {
+        const std::string &arg = args[i];
+        if (arg.starts_with("class:"))
+            rule.window_class = SCondition{arg.substr(6), is_plain(arg.substr(6))};
+        else if (arg.starts_with("title:"))
+            rule.title = SCondition{arg.substr(6), is_plain(arg.substr(6))};
+        else
+        {
+            result.setError(("hyprtile rule: unknown matcher " + arg).c_str());
+            return result;
+        }
+    }
+
+    if (!rule.window_class && !rule.title)
+    {
+        result.setError("hyprtile rule needs at least one of class: or title:");
+        return result;
+    }
+
+    parsed_rules.push_back(std::move(rule));
+    return result;
+}
+
+static std::unique_ptr<RE2::Set> compile_set(const std::vector<SRule> &rules,
+                                             std::optional<SCondition> SRule::*condition,
+                                             std::vector<size_t> &set_rules)
+{
+    RE2::Options options;
+    options.set_log_errors(false);
+    auto set = std::make_unique<RE2::Set>(options, RE2::ANCHOR_BOTH);
+
+    for (size_t i = 0; i < rules.size(); ++i)
+    {
+        const auto &cond = rules[i].*condition;
+        if (!cond || cond->exact)
+            continue;
+
+        std::string error;
+        if (set->Add(cond->pattern, &error) < 0)
+        {
+            Log::logger->log(Log::ERR, "[hyprtile] invalid rule regex {}: {}", cond->pattern, error);
+            continue;
+        }
+        set_rules.push_back(i);
+    }
+
+    if (set_rules.empty() || !set->Compile())
+    {
+        set_rules.clear();
+        return nullptr;
+    }
+    return set;
+}
+
+static void compile()
+{
+    matcher = SMatcher{};
+    matcher.rules = std::move(parsed_rules);
+    parsed_rules.clear();
+
+    for (size_t i = 0; i < matcher.rules.size(); ++i)
+    {
+        const auto &rule = matcher.rules[i];
+        if (rule.window_class && rule.window_class->exact)
+            matcher.exact_class[rule.window_class->pattern].push_back(i);
+        if (rule.title && rule.title->exact)
+            matcher.exact_title[rule.title->pattern].push_back(i);
+    }
+
+    matcher.class_set = compile_set(matcher.rules, &SRule::window_class, matcher.class_set_rules);
+    matcher.title_set = compile_set(matcher.rules, &SRule::title, matcher.title_set_rules);
+}
+
+static bool condition_matches(const std::optional<SCondition> &condition, const std::string &value,
+                              const std::vector<size_t> &regex_hits, size_t rule_index)
+{
+    if (!condition)
+        return true;
+    if (condition->exact)
+        return condition->pattern == value;
+    return std::ranges::binary_search(regex_hits, rule_index);
+}
+
+// First rule, in config order, that matches both class and title
+static const SRule *find_rule(const std::string &window_class, const std::string &title)
+{
+    if (matcher.rules.empty())
+        return nullptr;
+
+    auto regex_hits = [](const std::unique_ptr<RE2::Set> &set, const std::vector<size_t> &set_rules,
+                         const std::string &value) {
+        std::vector<size_t> hits;
+        std::vector<int> indices;
+        if (set && set->Match(value, &indices))
+        {
+            for (const int index : indices)
+                hits.push_back(set_rules[index]);
+            std::ranges::sort(hits);
+        }
+        return hits;
+    };
+
+    const auto class_hits = regex_hits(matcher.class_set, matcher.class_set_rules, window_class);
+    const auto title_hits = regex_hits(matcher.title_set, matcher.title_set_rules, title);
+
+    // every rule that matched at least one of its conditions, the other one is checked below
+    std::vector<size_t> candidates = class_hits;
+    candidates.insert(candidates.end(), title_hits.begin(), title_hits.end());
+    if (const auto it = matcher.exact_class.find(window_class); it != matcher.exact_class.end())
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    if (const auto it = matcher.exact_title.find(title); it != matcher.exact_title.end())
+        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+
+    std::ranges::sort(candidates);
+    for (const size_t index : candidates)
+    {
+        const SRule &rule = matcher.rules[index];
+        if (condition_matches(rule.window_class, window_class, class_hits, index) &&
+            condition_matches(rule.title, title, title_hits, index))
+            return &rule;
+    }
+
+    return nullptr;
+}
+
+// Monitor the column lives on, or the one the window opened on if the column is new
+static PHLMONITOR get_column_monitor(int column, const PHLWINDOW &window)
+{
+    for (const auto &workspace : g_pCompositor->getWorkspaces())
+    {
+        if (!workspace->m_isSpecialWorkspace && name_to_column(workspace->m_name) == column)
+            return workspace->m_monitor.lock();
+    }
+    return window->m_monitor.lock();
+}
+
+static int resolve_row(const SRule &rule, const PHLWINDOW &window)
+{
+    switch (rule.row_type)
+    {
+    case ROW_INDEX:
+        return rule.row;
+    case ROW_SAME_AS_PARENT:
+    {
+        const PHLWINDOW parent = window->parent();
+        if (parent && parent->m_workspace && name_to_column(parent->m_workspace->m_name) != -1)
+            return name_to_index(parent->m_workspace->m_name);
+        return std::max(0, topology::get_active_row(rule.column));
+    }
+    case ROW_NEXT_FREE:
+    {
+        // first row that doesn't exist yet or only holds the window being placed
+        for (int row = 0; row < INT_MAX; ++row)
+        {
+            const PHLWORKSPACE workspace = g_pCompositor->getWorkspaceByName(get_workspace_name(rule.column, row));
+            if (!workspace || workspace->getWindows() == 0 ||
+                (workspace->getWindows() == 1 && window->m_workspace == workspace))
+                return row;
+        }
+        return 0;
+    }
+    }
+    return 0;
+}
+
+static void on_window_open(PHLWINDOW window)
+{
+    if (!window || !window->m_workspace || window->m_workspace->m_isSpecialWorkspace)
+        return;
+
+    // windows coming back from the session snapshot keep the workspace they had
+    if (session::route_window(window))
+        return;
+
+    const SRule *rule = find_rule(window->m_initialClass, window->m_initialTitle);
+    if (!rule)
+        return;
+
+    const std::string workspace_name = get_workspace_name(rule->column, resolve_row(*rule, window));
+    if (window->m_workspace->m_name == workspace_name)
+        return;
+
+    const PHLWORKSPACE workspace = get_or_create_workspace(workspace_name, get_column_monitor(rule->column, window));
+    if (workspace)
+        g_pCompositor->moveWindowToWorkspaceSafe(window, workspace);
+}
+
+void init()
+{
+    HyprlandAPI::addConfigKeyword(PHANDLE, "plugin:hyprtile:rule", on_rule_keyword, Hyprlang::SHandlerOptions{});
+
+    auto &bus = Event::bus()->m_events;
+    listeners = {
+        bus.config.reloaded.listen([] { compile(); }),
+        bus.window.open.listen(on_window_open),
+    };
+}
+
+void exit()
+{
+    listeners.clear();
+    matcher = SMatcher{};
+}
+
+} // namespace placement
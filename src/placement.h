@@ -0,0 +1,12 @@
+#pragma once
+
+// Window placement rules targeting columns and sub-workspaces:
+//   plugin:hyprtile:rule = <column>, <row>, class:<regex>, title:<regex>
+// where row is a number, next-free or same-as-parent. Rules are compiled once per config reload
+namespace placement
+{
+
+void init();
+void exit();
+
+} // namespace placement
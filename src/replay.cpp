@@ -0,0 +1,343 @@
+#include "replay.h"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/debug/log/Logger.hpp>
+#include <hyprland/src/managers/KeybindManager.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <sstream>
+#include <unordered_map>
+#include <wayland-server-core.h>
+
+#include "globals.h"
+#include "trace.h"
+
+namespace replay
+{
+
+struct SEntry
+{
+    // relative to the start of the recording
+    uint64_t time_ns = 0;
+    std::string kind;
+    // dispatcher name + arg for "dispatch", numeric fields for inputs, free text for markers
+    std::string data;
+};
+
+static std::unordered_map<std::string, input_handler_t> input_handlers;
+
+static std::vector<SEntry> recorded;
+static uint64_t record_start_ns = 0;
+
+static std::vector<SEntry> playlist;
+static size_t playlist_pos = 0;
+static double playback_speed = 1.0;
+static uint64_t playback_start_ns = 0;
+static std::string playback_path;
+static wl_event_source *playback_timer = nullptr;
+
+static std::map<std::string, std::vector<uint64_t>> dispatch_latencies;
+static std::map<int64_t, std::vector<uint64_t>> frame_times;
+static std::map<int64_t, uint64_t> last_frame_ns;
+
+void add_input(const std::string &kind, input_handler_t handler)
+{
+    input_handlers[kind] = std::move(handler);
+}
+
+static void record(std::string kind, std::string data)
+{
+    recorded.push_back({trace::now_ns() - record_start_ns, std::move(kind), std::move(data)});
+}
+
+void record_input(const std::string &kind, const std::vector<double> &values)
+{
+    if (!recording())
+        return;
+
+    std::string data;
+    for (const double value : values)
+        data += std::format("{}{}", data.empty() ? "" : " ", value);
+    record(kind, std::move(data));
+}
+
+void record_dispatch(const std::string &name, const std::string &arg)
+{
+    if (!recording())
+        return;
+    record("dispatch", arg.empty() ? name : name + " " + arg);
+}
+
+void add_dispatcher(const char *name, SDispatchResult (*dispatcher)(std::string))
+{
+    HyprlandAPI::addDispatcherV2(PHANDLE, name, [name, dispatcher](std::string arg) {
+        HT_TRACE_SCOPE(name);
+        record_dispatch(name, arg);
+
+        if (!replaying())
+            return dispatcher(std::move(arg));
+
+        const uint64_t begin = trace::now_ns();
+        SDispatchResult result = dispatcher(std::move(arg));
+        note_dispatch_latency(name, trace::now_ns() - begin);
+        return result;
+    });
+}
+
+void record_marker(const std::string &kind, const std::string &data)
+{
+    if (!recording())
+        return;
+    record(kind, data);
+}
+
+void note_dispatch_latency(const std::string &name, uint64_t duration_ns)
+{
+    if (!replaying())
+        return;
+    dispatch_latencies[name].push_back(duration_ns);
+}
+
+void note_frame(int64_t monitor_id)
+{
+    if (!replaying())
+        return;
+
+    const uint64_t now = trace::now_ns();
+    const auto it = last_frame_ns.find(monitor_id);
+    if (it != last_frame_ns.end())
+        frame_times[monitor_id].push_back(now - it->second);
+    last_frame_ns[monitor_id] = now;
+}
+
+// ========== Log file ==========
+
+static bool write_log(const std::string &path, std::string &error)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.good())
+    {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    // one event per line: <microseconds> <kind> <data>
+    for (const auto &entry : recorded)
+        file << std::format("{} {} {}\n", entry.time_ns / 1000, entry.kind, entry.data);
+
+    if (!file.good())
+    {
+        error = "Failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+static bool read_log(const std::string &path, std::vector<SEntry> &entries, std::string &error)
+{
+    std::ifstream file(path);
+    if (!file.good())
+    {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+            continue;
+
+        std::istringstream stream(line);
+        uint64_t time_us;
+        SEntry entry;
+        if (!(stream >> time_us >> entry.kind))
+        {
+            error = "Malformed line in " + path + ": " + line;
+            return false;
+        }
+        std::getline(stream >> std::ws, entry.data);
+        entry.time_ns = time_us * 1000;
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+// ========== Playback ==========
+
+static std::string summarize(std::vector<uint64_t> values)
+{
+    std::ranges::sort(values);
+    uint64_t total = 0;
+    for (const uint64_t value : values)
+        total += value;
+
+    const auto percentile = [&values](double p) {
+        return values[std::min(values.size() - 1, (size_t)(values.size() * p))] / 1e6;
+    };
+    return std::format("count {} mean {:.3f}ms p50 {:.3f}ms p95 {:.3f}ms max {:.3f}ms", values.size(),
+                       total / 1e6 / values.size(), percentile(0.5), percentile(0.95), values.back() / 1e6);
+}
+
+static void finish_playback()
+{
+    replaying_enabled.store(false, std::memory_order_relaxed);
+    if (playback_timer != nullptr)
+        wl_event_source_remove(playback_timer);
+    playback_timer = nullptr;
+
+    const std::string report_path = playback_path + ".report";
+    std::ofstream report(report_path, std::ios::trunc);
+    report << std::format("replay of {} at {}x speed, {} events\n", playback_path, playback_speed, playlist.size());
+    for (const auto &[name, latencies] : dispatch_latencies)
+        report << std::format("dispatcher {} {}\n", name, summarize(latencies));
+    for (const auto &[monitor_id, times] : frame_times)
+    {
+        if (!times.empty())
+            report << std::format("frames monitor {} {}\n", monitor_id, summarize(times));
+    }
+
+    Log::logger->log(LOG, "[hyprtile] replay finished, report written to {}", report_path);
+    playlist.clear();
+}
+
+static void play(const SEntry &entry)
+{
+    if (entry.kind == "dispatch")
+    {
+        const auto space = entry.data.find_first_of(' ');
+        const std::string name = entry.data.substr(0, space);
+        const std::string arg = space == std::string::npos ? "" : entry.data.substr(space + 1);
+
+        const auto dispatcher = g_pKeybindManager->m_dispatchers.find(name);
+        if (dispatcher != g_pKeybindManager->m_dispatchers.end())
+            dispatcher->second(arg);
+        return;
+    }
+
+    const auto handler = input_handlers.find(entry.kind);
+    if (handler == input_handlers.end())
+        return;
+
+    std::vector<double> values;
+    std::istringstream stream(entry.data);
+    for (double value; stream >> value;)
+        values.push_back(value);
+
+    // a hand edited log with missing fields should not take the compositor down
+    try
+    {
+        handler->second(values);
+    }
+    catch (const std::out_of_range &)
+    {
+        Log::logger->log(Log::WARN, "[hyprtile] skipping malformed {} event in replay", entry.kind);
+    }
+}
+
+static int on_playback_timer(void *data)
+{
+    const uint64_t elapsed = (trace::now_ns() - playback_start_ns) * playback_speed;
+
+    while (playlist_pos < playlist.size() && playlist[playlist_pos].time_ns <= elapsed)
+        play(playlist[playlist_pos++]);
+
+    if (playlist_pos >= playlist.size())
+    {
+        finish_playback();
+        return 0;
+    }
+
+    const uint64_t wait_ns = (playlist[playlist_pos].time_ns - elapsed) / playback_speed;
+    wl_event_source_timer_update(playback_timer, std::max<uint64_t>(1, wait_ns / 1'000'000));
+    return 0;
+}
+
+void exit()
+{
+    recording_enabled.store(false, std::memory_order_relaxed);
+    replaying_enabled.store(false, std::memory_order_relaxed);
+    if (playback_timer != nullptr)
+        wl_event_source_remove(playback_timer);
+    playback_timer = nullptr;
+    input_handlers.clear();
+}
+
+SDispatchResult dispatch_record(std::string arg)
+{
+    const std::string command = arg.substr(0, arg.find_first_of(' '));
+    const std::string path = arg.find_first_of(' ') == std::string::npos ? "" : arg.substr(arg.find_first_of(' ') + 1);
+
+    if (command == "start")
+    {
+        recorded.clear();
+        record_start_ns = trace::now_ns();
+        recording_enabled.store(true, std::memory_order_relaxed);
+    }
+    else if (command == "stop")
+    {
+        recording_enabled.store(false, std::memory_order_relaxed);
+        if (path.empty())
+            return {.success = false, .error = "Missing path for record stop"};
+
+        std::string error;
+        if (!write_log(path, error))
+            return {.success = false, .error = error};
+    }
+    else
+        return {.success = false, .error = "Invalid record command, expected start or stop <path>"};
+
+    return {};
+}
+
+SDispatchResult dispatch_replay(std::string arg)
+{
+    if (replaying())
+        return {.success = false, .error = "A replay is already running"};
+
+    std::string path = arg;
+    playback_speed = 1.0;
+    if (const auto space = arg.find_last_of(' '); space != std::string::npos)
+    {
+        try
+        {
+            playback_speed = std::stod(arg.substr(space + 1));
+            path = arg.substr(0, space);
+        }
+        catch (...)
+        {
+            // no speed given, the space is part of the path
+        }
+    }
+    if (path.empty() || playback_speed <= 0)
+        return {.success = false, .error = "Usage: hyprtile:replay <path> [speed]"};
+
+    std::vector<SEntry> entries;
+    std::string error;
+    if (!read_log(path, entries, error))
+        return {.success = false, .error = error};
+    if (entries.empty())
+        return {};
+
+    playlist = std::move(entries);
+    playlist_pos = 0;
+    playback_path = path;
+    playback_start_ns = trace::now_ns();
+    dispatch_latencies.clear();
+    frame_times.clear();
+    last_frame_ns.clear();
+    replaying_enabled.store(true, std::memory_order_relaxed);
+
+    // the dispatcher that started the replay is still running, begin on the next event loop iteration
+    playback_timer = wl_event_loop_add_timer(g_pCompositor->m_wlEventLoop, on_playback_timer, nullptr);
+    wl_event_source_timer_update(playback_timer, 1);
+
+    return {};
+}
+
+} // namespace replay
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <hyprland/src/SharedDefs.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Record dispatcher calls and the overview's input events with their timing, and replay them later to compare
+// builds on the same workload. A replay collects dispatcher latencies and frame times into a report
+namespace replay
+{
+
+inline std::atomic<bool> recording_enabled = false;
+inline std::atomic<bool> replaying_enabled = false;
+
+inline bool recording()
+{
+    return recording_enabled.load(std::memory_order_relaxed);
+}
+
+inline bool replaying()
+{
+    return replaying_enabled.load(std::memory_order_relaxed);
+}
+
+// Input events are recorded as a kind and its numeric fields, replayed through the handler added for the kind
+using input_handler_t = std::function<void(const std::vector<double> &)>;
+void add_input(const std::string &kind, input_handler_t handler);
+void record_input(const std::string &kind, const std::vector<double> &values);
+
+// Register a dispatcher whose calls are recorded, timed during a replay and traced like any other scope
+void add_dispatcher(const char *name, SDispatchResult (*dispatcher)(std::string));
+
+void record_dispatch(const std::string &name, const std::string &arg);
+// Markers like overview open/close are only written to the log, their cause is what gets replayed
+void record_marker(const std::string &kind, const std::string &data);
+
+void note_dispatch_latency(const std::string &name, uint64_t duration_ns);
+void note_frame(int64_t monitor_id);
+
+void exit();
+
+// hyprtile:record <start|stop path>
+SDispatchResult dispatch_record(std::string arg);
+// hyprtile:replay <path> [speed]
+SDispatchResult dispatch_replay(std::string arg);
+
+} // namespace replay
@@ -0,0 +1,474 @@
+#include "session.h"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/config/ConfigValue.hpp>
+#include <hyprland/src/debug/log/Logger.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprland/src/event/EventBus.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wayland-server-core.h>
+
+#include "globals.h"
+#include "topology.h"
+#include "utils.h"
+#include "workspace_pool.h"
+
+namespace session
+{
+
+// "HTS" and a format version
+constexpr uint32_t MAGIC = 0x48545301;
+
+struct SWorkspace
+{
+    std::string name;
+    std::string monitor;
+};
+
+struct SWindow
+{
+    std::string window_class;
+    std::string title;
+    std::string workspace;
+};
+
+struct SSnapshot
+{
+    std::vector<SWorkspace> workspaces;
+    // column, row last shown in it
+    std::vector<std::pair<int32_t, int32_t>> active_rows;
+    std::vector<SWindow> windows;
+};
+
+// initial class -> (initial title, workspace name) of the windows still expected to come back
+static std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> pending_windows;
+// workspaces recreated from the snapshot, kept alive until their windows are back or the restore times out
+static std::vector<PHLWORKSPACE> restored_workspaces;
+static bool restoring = false;
+// column -> row last shown in it according to the snapshot, until a switch to that column used it
+static std::unordered_map<int, int> restored_rows;
+
+static std::vector<std::any> listeners;
+
+static wl_event_source *save_timer = nullptr;
+static wl_event_source *restore_timer = nullptr;
+static std::thread writer;
+static std::atomic<bool> writing = false;
+
+void init_config()
+{
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:session:enabled", Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:session:path", Hyprlang::STRING{""});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:session:save_delay", Hyprlang::INT{2000});
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:session:restore_timeout", Hyprlang::INT{30000});
+}
+
+static bool enabled()
+{
+    static auto PENABLED = CConfigValue<Hyprlang::INT>("plugin:hyprtile:session:enabled");
+    return *PENABLED;
+}
+
+static std::filesystem::path get_path()
+{
+    static auto PPATH = CConfigValue<Hyprlang::STRING>("plugin:hyprtile:session:path");
+    const std::string path = *PPATH;
+    const char *home = getenv("HOME");
+    if (path.starts_with("~/") && home)
+        return std::filesystem::path(home) / path.substr(2);
+    if (!path.empty())
+        return path;
+
+    if (const char *state_home = getenv("XDG_STATE_HOME"); state_home && *state_home)
+        return std::filesystem::path(state_home) / "hyprtile" / "session.bin";
+
+    return std::filesystem::path(home ? home : "/tmp") / ".local" / "state" / "hyprtile" / "session.bin";
+}
+
+// ========== Serialization ==========
+
+static void write_u32(std::string &out, uint32_t value)
+{
+    out.append((const char *)&value, sizeof(value));
+}
+
+static void write_string(std::string &out, const std::string &value)
+{
+    write_u32(out, value.size());
+    out += value;
+}
+
+static std::string serialize(const SSnapshot &snapshot)
+{
+    std::string out;
+    write_u32(out, MAGIC);
+
+    write_u32(out, snapshot.workspaces.size());
+    for (const auto &workspace : snapshot.workspaces)
+    {
+        write_string(out, workspace.name);
+        write_string(out, workspace.monitor);
+    }
+
+    write_u32(out, snapshot.active_rows.size());
+    for (const auto &[column, row] : snapshot.active_rows)
+    {
+        write_u32(out, column);
+        write_u32(out, row);
+    }
+
+    write_u32(out, snapshot.windows.size());
+    for (const auto &window : snapshot.windows)
+    {
+        write_string(out, window.window_class);
+        write_string(out, window.title);
+        write_string(out, window.workspace);
+    }
+
+    return out;
+}
+
+class CReader
+{
+  public:
+    explicit CReader(const std::string &data) : data(data)
+    {
+    }
+
+    bool read_u32(uint32_t &value)
+    {
+        if (pos + sizeof(value) > data.size())
+            return false;
+        memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    bool read_string(std::string &value)
+    {
+        uint32_t size;
+        if (!read_u32(size) || pos + size > data.size())
+            return false;
+        value = data.substr(pos, size);
+        pos += size;
+        return true;
+    }
+
+    // A record count, rejected if the rest of the data can't hold that many records of at least min_record_size
+    // bytes, so a corrupted count never turns into a huge allocation
+    bool read_count(uint32_t &count, size_t min_record_size)
+    {
+        return read_u32(count) && count <= (data.size() - pos) / min_record_size;
+    }
+
+  private:
+    const std::string &data;
+    size_t pos = 0;
+};
+
+static bool deserialize(const std::string &data, SSnapshot &snapshot)
+{
+    CReader reader(data);
+    uint32_t magic, count;
+    if (!reader.read_u32(magic) || magic != MAGIC)
+        return false;
+
+    // two string sizes
+    if (!reader.read_count(count, 2 * sizeof(uint32_t)))
+        return false;
+    snapshot.workspaces.resize(count);
+    for (auto &workspace : snapshot.workspaces)
+    {
+        if (!reader.read_string(workspace.name) || !reader.read_string(workspace.monitor))
+            return false;
+    }
+
+    if (!reader.read_count(count, 2 * sizeof(uint32_t)))
+        return false;
+    snapshot.active_rows.resize(count);
+    for (auto &[column, row] : snapshot.active_rows)
+    {
+        if (!reader.read_u32((uint32_t &)column) || !reader.read_u32((uint32_t &)row))
+            return false;
+    }
+
+    // three string sizes
+    if (!reader.read_count(count, 3 * sizeof(uint32_t)))
+        return false;
+    snapshot.windows.resize(count);
+    for (auto &window : snapshot.windows)
+    {
+        if (!reader.read_string(window.window_class) || !reader.read_string(window.title) ||
+            !reader.read_string(window.workspace))
+            return false;
+    }
+
+    return true;
+}
+
+// ========== Saving ==========
+
+static SSnapshot capture()
+{
+    SSnapshot snapshot;
+
+    for (const auto &workspace : g_pCompositor->getWorkspaces())
+    {
+        if (workspace->m_isSpecialWorkspace || name_to_column(workspace->m_name) == -1)
+            continue;
+        if (workspace_pool::is_parked(workspace.lock()))
+            continue;
+
+        const PHLMONITOR monitor = workspace->m_monitor.lock();
+        snapshot.workspaces.push_back({workspace->m_name, monitor ? monitor->m_name : ""});
+
+        const int column = name_to_column(workspace->m_name);
+        const int row = topology::get_active_row(column);
+        if (row != -1 && std::ranges::find(snapshot.active_rows, column, &std::pair<int32_t, int32_t>::first) ==
+                             snapshot.active_rows.end())
+            snapshot.active_rows.push_back({column, row});
+    }
+
+    for (const auto &window : g_pCompositor->m_windows)
+    {
+        if (!window->m_isMapped || !window->m_workspace || window->m_workspace->m_isSpecialWorkspace)
+            continue;
+        if (name_to_column(window->m_workspace->m_name) == -1)
+            continue;
+
+        snapshot.windows.push_back({window->m_initialClass, window->m_initialTitle, window->m_workspace->m_name});
+    }
+
+    return snapshot;
+}
+
+static void write_file(std::filesystem::path path, std::string data)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // write next to it and rename, so a crash mid-write never leaves a truncated snapshot behind
+    const auto tmp_path = std::filesystem::path(path).concat(".tmp");
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+        if (!file)
+        {
+            writing = false;
+            return;
+        }
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+
+    writing = false;
+}
+
+static void save()
+{
+    // the previous write is still in flight, try again once it is done
+    if (writing)
+    {
+        schedule_save();
+        return;
+    }
+
+    if (writer.joinable())
+        writer.join();
+
+    // capturing has to happen here, the compositor state isn't safe to touch from the writer thread
+    writing = true;
+    writer = std::thread(write_file, get_path(), serialize(capture()));
+}
+
+void schedule_save()
+{
+    // Don't overwrite the snapshot with the half restored state
+    if (restoring || !enabled() || g_pCompositor == nullptr)
+        return;
+
+    static auto PDELAY = CConfigValue<Hyprlang::INT>("plugin:hyprtile:session:save_delay");
+
+    if (save_timer == nullptr)
+    {
+        save_timer = wl_event_loop_add_timer(
+            g_pCompositor->m_wlEventLoop,
+            [](void *data) {
+                save();
+                return 0;
+            },
+            nullptr);
+    }
+
+    // debounce, every change pushes the write back
+    wl_event_source_timer_update(save_timer, std::max<Hyprlang::INT>(1, *PDELAY));
+}
+
+// ========== Restoring ==========
+
+static void finish_restore()
+{
+    restoring = false;
+    pending_windows.clear();
+    // Hyprland cleans the ones that stayed empty up as usual
+    restored_workspaces.clear();
+
+    if (restore_timer != nullptr)
+        wl_event_source_remove(restore_timer);
+    restore_timer = nullptr;
+}
+
+bool route_window(const PHLWINDOW &window)
+{
+    if (!restoring || !window)
+        return false;
+
+    const auto bucket = pending_windows.find(window->m_initialClass);
+    if (bucket == pending_windows.end())
+        return false;
+
+    // the entry with the same title, or the only one of that class. Guessing between several would shuffle windows
+    // of the same class, and move windows the user just opened somewhere else
+    auto &entries = bucket->second;
+    auto entry = std::ranges::find(entries, window->m_initialTitle, &std::pair<std::string, std::string>::first);
+    if (entry == entries.end())
+    {
+        if (entries.size() != 1)
+            return false;
+        entry = entries.begin();
+    }
+
+    const std::string workspace_name = entry->second;
+    entries.erase(entry);
+    if (entries.empty())
+        pending_windows.erase(bucket);
+
+    if (!window->m_workspace || window->m_workspace->m_name != workspace_name)
+    {
+        const PHLWORKSPACE workspace = get_or_create_workspace(workspace_name, window->m_monitor.lock());
+        if (workspace)
+            g_pCompositor->moveWindowToWorkspaceSafe(window, workspace);
+    }
+
+    if (pending_windows.empty())
+        finish_restore();
+
+    return true;
+}
+
+int take_restored_row(int column)
+{
+    const auto it = restored_rows.find(column);
+    if (it == restored_rows.end())
+        return -1;
+
+    const int row = it->second;
+    restored_rows.erase(it);
+    return row;
+}
+
+static void restore(const SSnapshot &snapshot)
+{
+    for (const auto &[column, row] : snapshot.active_rows)
+    {
+        topology::restore_active_row(column, row);
+        restored_rows.try_emplace(column, row);
+    }
+
+    for (const auto &window : snapshot.windows)
+        pending_windows[window.window_class].push_back({window.title, window.workspace});
+
+    if (pending_windows.empty())
+        return;
+
+    restoring = true;
+
+    // Recreate every workspace that gets windows back in one go, on the monitor it was on if that is still there
+    const PHLMONITOR fallback_monitor = g_pCompositor->m_monitors.empty() ? nullptr : g_pCompositor->m_monitors.front();
+    for (const auto &saved : snapshot.workspaces)
+    {
+        if (std::ranges::none_of(snapshot.windows,
+                                 [&saved](const SWindow &window) { return window.workspace == saved.name; }))
+            continue;
+
+        PHLMONITOR monitor = saved.monitor.empty() ? nullptr : g_pCompositor->getMonitorFromName(saved.monitor);
+        if (!monitor)
+            monitor = fallback_monitor;
+
+        const PHLWORKSPACE workspace = get_or_create_workspace(saved.name, monitor);
+        if (workspace)
+            restored_workspaces.push_back(workspace);
+    }
+
+    static auto PTIMEOUT = CConfigValue<Hyprlang::INT>("plugin:hyprtile:session:restore_timeout");
+    restore_timer = wl_event_loop_add_timer(
+        g_pCompositor->m_wlEventLoop,
+        [](void *data) {
+            finish_restore();
+            return 0;
+        },
+        nullptr);
+    wl_event_source_timer_update(restore_timer, std::max<Hyprlang::INT>(1, *PTIMEOUT));
+}
+
+void init()
+{
+    // Window changes don't always change the topology, but they do change what the snapshot holds
+    auto &bus = Event::bus()->m_events;
+    listeners = {
+        bus.window.open.listen([](auto &&...) { schedule_save(); }),
+        bus.window.close.listen([](auto &&...) { schedule_save(); }),
+        bus.window.moveToWorkspace.listen([](auto &&...) { schedule_save(); }),
+    };
+
+    if (!enabled())
+        return;
+
+    // Loaded into a running session, e.g. by hyprctl plugin load or a plugin reload: the windows are where the
+    // user put them, the snapshot would only move them around
+    if (std::ranges::any_of(g_pCompositor->m_windows, [](const PHLWINDOW &window) { return window->m_isMapped; }))
+        return;
+
+    std::ifstream file(get_path(), std::ios::binary);
+    if (!file)
+        return;
+
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    SSnapshot snapshot;
+    if (!deserialize(data, snapshot))
+    {
+        Log::logger->log(Log::WARN, "[hyprtile] ignoring unreadable session snapshot {}", get_path().string());
+        return;
+    }
+
+    restore(snapshot);
+}
+
+void exit()
+{
+    listeners.clear();
+    finish_restore();
+    restored_rows.clear();
+
+    if (save_timer != nullptr)
+        wl_event_source_remove(save_timer);
+    save_timer = nullptr;
+
+    if (writer.joinable())
+        writer.join();
+}
+
+} // namespace session
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+
+#include <string>
+
+// Snapshot of the column layout kept on disk, so it can be rebuilt after the compositor restarts: workspace
+// names and monitors, the row last shown in every column and which workspace each window was on
+namespace session
+{
+
+void init_config();
+
+// Restore the last snapshot, if any, and start routing newly mapped windows back to their workspace
+void init();
+void exit();
+
+// Move a newly mapped window back to the workspace it had in the snapshot, false if it isn't one of them
+bool route_window(const PHLWINDOW &window);
+
+// Row the snapshot had last shown in column, -1 if there is none. Only given out once, later switches to the
+// column go to row 0 like they always did
+int take_restored_row(int column);
+
+// The topology changed, write a new snapshot once things settle down
+void schedule_save();
+
+} // namespace session
@@ -0,0 +1,145 @@
+#include "symbols.h"
+
+#include <hyprland/src/debug/log/Logger.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include <cstdlib>
+#include <dlfcn.h>
+#include <filesystem>
+#include <fstream>
+#include <link.h>
+#include <sstream>
+#include <unordered_map>
+
+#include "globals.h"
+
+namespace symbols
+{
+
+struct SEntry
+{
+    // from the load address of the compositor, which moves between runs
+    uintptr_t offset = 0;
+    std::string signature;
+};
+
+static std::unordered_map<std::string, SEntry> entries;
+static bool loaded = false;
+static bool dirty = false;
+static size_t hits = 0;
+static size_t misses = 0;
+
+static uintptr_t get_base_address()
+{
+    // the first object dl_iterate_phdr reports is the executable itself
+    uintptr_t base = 0;
+    dl_iterate_phdr(
+        [](dl_phdr_info *info, size_t, void *data) {
+            *(uintptr_t *)data = info->dlpi_addr;
+            return 1;
+        },
+        &base);
+    return base;
+}
+
+static std::filesystem::path get_cache_path()
+{
+    // the hash changes with every compositor build, so a stale file is simply never looked at again
+    const std::string file_name = std::string("symbols-") + __hyprland_api_get_hash();
+
+    if (const char *cache_home = getenv("XDG_CACHE_HOME"); cache_home && *cache_home)
+        return std::filesystem::path(cache_home) / "hyprtile" / file_name;
+
+    const char *home = getenv("HOME");
+    return std::filesystem::path(home ? home : "/tmp") / ".cache" / "hyprtile" / file_name;
+}
+
+static void load()
+{
+    loaded = true;
+
+    std::ifstream file(get_cache_path());
+    std::string line;
+    // one symbol per line: <name>\t<offset>\t<signature>
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string name;
+        SEntry entry;
+        if (std::getline(stream, name, '\t') && stream >> std::hex >> entry.offset && stream.get() == '\t' &&
+            std::getline(stream, entry.signature) && !entry.signature.empty())
+            entries[name] = std::move(entry);
+    }
+}
+
+// The cached address still has to be the start of a function with the same mangled name
+static bool is_valid(void *address, const std::string &signature)
+{
+    Dl_info info;
+    return dladdr(address, &info) != 0 && info.dli_saddr == address && info.dli_sname != nullptr &&
+           signature == info.dli_sname;
+}
+
+SSymbol find(const std::string &name)
+{
+    if (!loaded)
+        load();
+
+    const uintptr_t base = get_base_address();
+    if (const auto it = entries.find(name); it != entries.end())
+    {
+        void *address = (void *)(base + it->second.offset);
+        if (is_valid(address, it->second.signature))
+        {
+            hits++;
+            return {address, it->second.signature};
+        }
+
+        Log::logger->log(Log::WARN, "[hyprtile] cached symbol for {} is stale, resolving it again", name);
+        entries.erase(it);
+        dirty = true;
+    }
+
+    misses++;
+    const auto matches = HyprlandAPI::findFunctionsByName(PHANDLE, name);
+    if (matches.empty())
+        return {};
+
+    entries[name] = {(uintptr_t)matches[0].address - base, matches[0].signature};
+    dirty = true;
+    return {matches[0].address, matches[0].signature};
+}
+
+void save()
+{
+    if (!dirty)
+        return;
+    dirty = false;
+
+    const std::filesystem::path path = get_cache_path();
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // write next to it and rename, so a concurrent load never reads half a file
+    const auto tmp_path = std::filesystem::path(path).concat(".tmp");
+    {
+        std::ofstream file(tmp_path, std::ios::trunc);
+        for (const auto &[name, entry] : entries)
+            file << name << '\t' << std::hex << entry.offset << std::dec << '\t' << entry.signature << '\n';
+        if (!file)
+            return;
+    }
+    std::filesystem::rename(tmp_path, path, ec);
+}
+
+size_t cache_hits()
+{
+    return hits;
+}
+
+size_t cache_misses()
+{
+    return misses;
+}
+
+} // namespace symbols
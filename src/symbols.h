@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+
+// Cache of the hook addresses resolved through HyprlandAPI::findFunctionsByName, which scans the compositor's
+// whole symbol table on every call. Entries are kept per compositor build as offsets from the executable's load
+// address, and each is checked against the dynamic symbol table before it is used
+namespace symbols
+{
+
+struct SSymbol
+{
+    // nullptr if the compositor has no such function
+    void *address = nullptr;
+    std::string signature;
+};
+
+// The first match findFunctionsByName would return for name
+SSymbol find(const std::string &name);
+
+// Write the symbols resolved during this load for the next one
+void save();
+
+// For the load time report
+size_t cache_hits();
+size_t cache_misses();
+
+} // namespace symbols
@@ -0,0 +1,408 @@
+#include "topology.h"
+
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/debug/HyprCtl.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/desktop/state/FocusState.hpp>
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprland/src/event/EventBus.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include <algorithm>
+#include <any>
+#include <format>
+#include <map>
+#include <vector>
+#include <wayland-server-core.h>
+
+#include "event_socket.h"
+#include "globals.h"
+#include "session.h"
+#include "utils.h"
+#include "workspace_pool.h"
+
+namespace topology
+{
+
+struct SWorkspace
+{
+    WORKSPACEID id;
+    std::string name;
+    int row;
+    int windows;
+    bool active;
+
+    bool operator==(const SWorkspace &) const = default;
+};
+
+struct SColumn
+{
+    int column;
+    int active_row;
+    std::vector<SWorkspace> workspaces;
+
+    bool operator==(const SColumn &) const = default;
+};
+
+struct SMonitor
+{
+    MONITORID id;
+    std::string name;
+    bool focused;
+    std::vector<SColumn> columns;
+
+    bool operator==(const SMonitor &) const = default;
+};
+
+struct SModel
+{
+    std::vector<SMonitor> monitors;
+    uintptr_t focused_window = 0;
+
+    bool operator==(const SModel &) const = default;
+};
+
+// column -> row last shown in it
+static std::map<int, int> active_rows;
+
+// kept up to date by changed(), so queries only rebuild it after something happened
+static SModel model;
+static bool model_dirty = true;
+static std::string cached_json;
+static std::string cached_text;
+
+// last state posted to the event socket
+static SModel published;
+static wl_event_source *publish_source = nullptr;
+static std::vector<std::any> listeners;
+
+void note_active(const PHLWORKSPACE &workspace)
+{
+    if (!workspace || workspace->m_isSpecialWorkspace)
+        return;
+
+    const int column = name_to_column(workspace->m_name);
+    if (column == -1)
+        return;
+
+    active_rows[column] = name_to_index(workspace->m_name);
+    changed();
+}
+
+void restore_active_row(int column, int row)
+{
+    active_rows.try_emplace(column, row);
+}
+
+int get_active_row(int column)
+{
+    const auto it = active_rows.find(column);
+    return it == active_rows.end() ? -1 : it->second;
+}
+
+static SModel collect()
+{
+    SModel result;
+
+    const PHLMONITOR focused_monitor = Desktop::focusState()->monitor();
+    const PHLWINDOW focused_window = Desktop::focusState()->window();
+    result.focused_window = (uintptr_t)focused_window.get();
+
+    for (const auto &monitor : g_pCompositor->m_monitors)
+    {
+        if (!monitor->m_enabled)
+            continue;
+
+        SMonitor &entry = result.monitors.emplace_back(SMonitor{
+            .id = monitor->m_id,
+            .name = monitor->m_name,
+            .focused = monitor == focused_monitor,
+            .columns = {},
+        });
+
+        for (const auto &workspace : g_pCompositor->getWorkspaces())
+        {
+            if (workspace->m_monitor != monitor || workspace->m_isSpecialWorkspace)
+                continue;
+
+            const int column = name_to_column(workspace->m_name);
+            if (column == -1 || workspace_pool::is_parked(workspace.lock()))
+                continue;
+
+            auto it = std::ranges::find(entry.columns, column, &SColumn::column);
+            if (it == entry.columns.end())
+            {
+                const auto row = active_rows.find(column);
+                entry.columns.push_back({column, row == active_rows.end() ? 0 : row->second, {}});
+                it = std::prev(entry.columns.end());
+            }
+
+            it->workspaces.push_back({
+                .id = workspace->m_id,
+                .name = workspace->m_name,
+                .row = name_to_index(workspace->m_name),
+                .windows = workspace->getWindows(),
+                .active = monitor->m_activeWorkspace == workspace,
+            });
+        }
+
+        std::ranges::sort(entry.columns, {}, &SColumn::column);
+        for (auto &column : entry.columns)
+            std::ranges::sort(column.workspaces, {}, &SWorkspace::row);
+    }
+
+    return result;
+}
+
+static std::string escape(const std::string &str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+                result += std::format("\\u{:04x}", c);
+            else
+                result += c;
+        }
+    }
+    return result;
+}
+
+static std::string to_json(const SModel &topology)
+{
+    std::string result = std::format(R"({{"focusedWindow":"{:#x}","monitors":[)", topology.focused_window);
+    for (size_t m = 0; m < topology.monitors.size(); ++m)
+    {
+        const auto &monitor = topology.monitors[m];
+        result += std::format(R"({}{{"id":{},"name":"{}","focused":{},"columns":[)", m ? "," : "", monitor.id,
+                              escape(monitor.name), monitor.focused);
+
+        for (size_t c = 0; c < monitor.columns.size(); ++c)
+        {
+            const auto &column = monitor.columns[c];
+            result += std::format(R"({}{{"column":{},"activeRow":{},"workspaces":[)", c ? "," : "", column.column,
+                                  column.active_row);
+
+            for (size_t w = 0; w < column.workspaces.size(); ++w)
+            {
+                const auto &workspace = column.workspaces[w];
+                result += std::format(R"({}{{"id":{},"name":"{}","row":{},"windows":{},"active":{}}})", w ? "," : "",
+                                      workspace.id, escape(remove_padding(workspace.name)), workspace.row,
+                                      workspace.windows, workspace.active);
+            }
+            result += "]}";
+        }
+        result += "]}";
+    }
+    result += "]}";
+    return result;
+}
+
+static std::string to_text(const SModel &topology)
+{
+    std::string result;
+    for (const auto &monitor : topology.monitors)
+    {
+        result += std::format("Monitor {} (ID {}){}:\n", monitor.name, monitor.id, monitor.focused ? " focused" : "");
+        for (const auto &column : monitor.columns)
+        {
+            result += std::format("\tcolumn {} (active row {}):", column.column, column.active_row);
+            for (const auto &workspace : column.workspaces)
+                result += std::format(" {}[{}]{}", remove_padding(workspace.name), workspace.windows,
+                                      workspace.active ? "*" : "");
+            result += "\n";
+        }
+        result += "\n";
+    }
+    return result;
+}
+
+// Rebuild the model if a change came in since the last time, dropping the serialized copies only if it differs
+static const SModel &get_model()
+{
+    if (!model_dirty)
+        return model;
+    model_dirty = false;
+
+    SModel current = collect();
+    if (current != model)
+    {
+        model = std::move(current);
+        cached_json.clear();
+        cached_text.clear();
+    }
+    return model;
+}
+
+const std::string &get(bool json)
+{
+    // Polling clients are served the serialized model as long as nothing changed
+    const SModel &current = get_model();
+    std::string &cached = json ? cached_json : cached_text;
+    if (cached.empty())
+        cached = json ? to_json(current) : to_text(current);
+    return cached;
+}
+
+// Everything diff() compares, flattened out of the per-monitor tree
+struct SFlatWorkspace
+{
+    std::string monitor;
+    int column;
+    std::string name;
+};
+
+static std::map<WORKSPACEID, SFlatWorkspace> flatten(const SModel &topology)
+{
+    std::map<WORKSPACEID, SFlatWorkspace> result;
+    for (const auto &monitor : topology.monitors)
+    {
+        for (const auto &column : monitor.columns)
+        {
+            for (const auto &workspace : column.workspaces)
+                result[workspace.id] = {monitor.name, column.column, remove_padding(workspace.name)};
+        }
+    }
+    return result;
+}
+
+// column -> monitor name, and column -> active row
+static std::map<int, std::string> column_monitors(const SModel &topology, std::map<int, int> &rows)
+{
+    std::map<int, std::string> result;
+    for (const auto &monitor : topology.monitors)
+    {
+        for (const auto &column : monitor.columns)
+        {
+            // a column split over monitors belongs to the first one it shows up on
+            result.try_emplace(column.column, monitor.name);
+            rows.try_emplace(column.column, column.active_row);
+        }
+    }
+    return result;
+}
+
+static void diff(const SModel &before, const SModel &after)
+{
+    std::map<int, int> rows_before, rows_after;
+    const auto columns_before = column_monitors(before, rows_before);
+    const auto columns_after = column_monitors(after, rows_after);
+
+    for (const auto &[column, monitor] : columns_before)
+    {
+        if (!columns_after.contains(column))
+            event_socket::post("columnremoved", std::format("{},{}", monitor, column));
+    }
+    for (const auto &[column, monitor] : columns_after)
+    {
+        const auto it = columns_before.find(column);
+        if (it == columns_before.end())
+            event_socket::post("columnadded", std::format("{},{}", monitor, column));
+        else if (it->second != monitor)
+            event_socket::post("columnmoved", std::format("{},{},{}", column, it->second, monitor));
+    }
+
+    const auto workspaces_before = flatten(before);
+    const auto workspaces_after = flatten(after);
+
+    for (const auto &[id, workspace] : workspaces_before)
+    {
+        if (!workspaces_after.contains(id))
+            event_socket::post("subworkspaceremoved", std::format("{},{}", id, workspace.name));
+    }
+    for (const auto &[id, workspace] : workspaces_after)
+    {
+        const auto it = workspaces_before.find(id);
+        if (it == workspaces_before.end())
+            event_socket::post("subworkspaceadded", std::format("{},{}", id, workspace.name));
+        else if (it->second.name != workspace.name)
+            event_socket::post("subworkspacerenamed", std::format("{},{},{}", id, it->second.name, workspace.name));
+    }
+
+    for (const auto &[column, row] : rows_after)
+    {
+        const auto it = rows_before.find(column);
+        if (it != rows_before.end() && it->second != row)
+            event_socket::post("activerowchanged", std::format("{},{}", column, row));
+    }
+}
+
+void changed()
+{
+    model_dirty = true;
+    if (publish_source != nullptr || g_pCompositor == nullptr)
+        return;
+
+    publish_source = wl_event_loop_add_idle(
+        g_pCompositor->m_wlEventLoop,
+        [](void *data) {
+            publish_source = nullptr;
+
+            const SModel &current = get_model();
+            if (current == published)
+                return;
+
+            diff(published, current);
+            published = current;
+
+            session::schedule_save();
+        },
+        nullptr);
+}
+
+static std::string hyprctl_topology(eHyprCtlOutputFormat format, std::string request)
+{
+    return get(format == eHyprCtlOutputFormat::FORMAT_JSON);
+}
+
+void init()
+{
+    HyprlandAPI::registerHyprCtlCommand(PHANDLE, SHyprCtlCommand{
+                                                     .name = "hyprtile:topology",
+                                                     .exact = true,
+                                                     .fn = hyprctl_topology,
+                                                 });
+
+    model_dirty = true;
+    published = get_model();
+
+    // Workspace renames don't have an event, the dispatchers that rename call changed() themselves. Window events
+    // change the window counts and the focused window the model holds
+    auto &bus = Event::bus()->m_events;
+    listeners = {
+        bus.window.open.listen([](auto &&...) { changed(); }),
+        bus.window.close.listen([](auto &&...) { changed(); }),
+        bus.window.moveToWorkspace.listen([](auto &&...) { changed(); }),
+        bus.window.active.listen([](auto &&...) { changed(); }),
+        bus.workspace.created.listen([](auto &&...) { changed(); }),
+        bus.workspace.removed.listen([](auto &&...) { changed(); }),
+        bus.workspace.active.listen([](auto &&...) { changed(); }),
+        bus.workspace.moveToMonitor.listen([](auto &&...) { changed(); }),
+        bus.monitor.added.listen([](auto &&...) { changed(); }),
+        bus.monitor.removed.listen([](auto &&...) { changed(); }),
+    };
+}
+
+void exit()
+{
+    listeners.clear();
+    if (publish_source != nullptr)
+        wl_event_source_remove(publish_source);
+    publish_source = nullptr;
+}
+
+} // namespace topology
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+
+#include <string>
+
+// Column/sub-workspace model exposed to bars and scripts through `hyprctl hyprtile:topology`, so they don't
+// have to re-parse padded workspace names themselves
+namespace topology
+{
+
+void init();
+void exit();
+
+// Something that may affect the topology happened, diff it against the last published state on the next event
+// loop iteration and post the differences to the event socket. Batches of changes coalesce into one diff
+void changed();
+
+// Remember the row last shown in the column of workspace, called on every workspace change
+void note_active(const PHLWORKSPACE &workspace);
+void restore_active_row(int column, int row);
+// Row last shown in column, -1 if it has not been shown yet
+int get_active_row(int column);
+
+// Serialized topology, only regenerated when the model differs from the last query
+const std::string &get(bool json);
+
+} // namespace topology
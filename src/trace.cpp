@@ -0,0 +1,167 @@
+#include "trace.h"
+
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+#include "globals.h"
+
+namespace trace
+{
+
+struct SEvent
+{
+    // index + 1 of the record that last wrote this slot, 0 while empty or being written
+    std::atomic<uint64_t> sequence = 0;
+    const char *name = nullptr;
+    int64_t id = -1;
+    uint64_t begin_ns = 0;
+    uint64_t end_ns = 0;
+    uint32_t tid = 0;
+};
+
+// power of two so the slot is a mask of the write index
+constexpr uint64_t CAPACITY = 1 << 16;
+
+static std::unique_ptr<SEvent[]> events;
+static std::atomic<uint64_t> head = 0;
+
+struct SLoadPhase
+{
+    const char *name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+static std::vector<SLoadPhase> load_phases;
+
+uint64_t now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+}
+
+void record(const char *name, int64_t id, uint64_t begin_ns, uint64_t end_ns)
+{
+    static thread_local const uint32_t tid = gettid();
+
+    const uint64_t index = head.fetch_add(1, std::memory_order_relaxed);
+    SEvent &event = events[index & (CAPACITY - 1)];
+
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.id = id;
+    event.begin_ns = begin_ns;
+    event.end_ns = end_ns;
+    event.tid = tid;
+    event.sequence.store(index + 1, std::memory_order_release);
+}
+
+void record_load(const char *name, uint64_t begin_ns, uint64_t end_ns)
+{
+    load_phases.push_back({name, begin_ns, end_ns});
+}
+
+void start()
+{
+    if (events == nullptr)
+        events = std::make_unique<SEvent[]>(CAPACITY);
+    tracing_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    tracing_enabled.store(false, std::memory_order_relaxed);
+}
+
+void clear()
+{
+    head.store(0, std::memory_order_relaxed);
+    if (events == nullptr)
+        return;
+    for (uint64_t i = 0; i < CAPACITY; i++)
+        events[i].sequence.store(0, std::memory_order_relaxed);
+}
+
+bool dump(const std::string &path, std::string &error)
+{
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.good())
+    {
+        error = "Could not open " + path;
+        return false;
+    }
+
+    const int pid = getpid();
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << std::format(
+        "{{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":{},\"tid\":{},\"args\":{{\"name\":\"hyprtile\"}}}}", pid, pid);
+
+    // loading happens on the compositor's main thread, which has the process id as its thread id
+    for (const SLoadPhase &phase : load_phases)
+        file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"hyprtile\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+                            "\"pid\":{},\"tid\":{}}}",
+                            phase.name, phase.begin_ns / 1000.0, (phase.end_ns - phase.begin_ns) / 1000.0, pid, pid);
+
+    const uint64_t end = head.load(std::memory_order_acquire);
+    const uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    for (uint64_t index = begin; events != nullptr && index < end; index++)
+    {
+        const SEvent &event = events[index & (CAPACITY - 1)];
+
+        // skip slots that were overwritten or are being written while dumping
+        if (event.sequence.load(std::memory_order_acquire) != index + 1)
+            continue;
+
+        file << std::format(",\n{{\"name\":\"{}\",\"cat\":\"hyprtile\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},"
+                            "\"pid\":{},\"tid\":{}",
+                            event.name, event.begin_ns / 1000.0, (event.end_ns - event.begin_ns) / 1000.0, pid,
+                            event.tid);
+        if (event.id != -1)
+            file << std::format(",\"args\":{{\"id\":{}}}", event.id);
+        file << "}";
+    }
+
+    file << "\n]}\n";
+    if (!file.good())
+    {
+        error = "Failed writing " + path;
+        return false;
+    }
+    return true;
+}
+
+SDispatchResult dispatch_trace(std::string arg)
+{
+    const std::string command = arg.substr(0, arg.find_first_of(' '));
+    const std::string path = arg.find_first_of(' ') == std::string::npos ? "" : arg.substr(arg.find_first_of(' ') + 1);
+
+    if (command == "start")
+        start();
+    else if (command == "stop")
+        stop();
+    else if (command == "clear")
+        clear();
+    else if (command == "dump")
+    {
+        if (path.empty())
+            return {.success = false, .error = "Missing path for trace dump"};
+
+        std::string error;
+        if (!dump(path, error))
+            return {.success = false, .error = error};
+    }
+    else
+        return {.success = false, .error = "Invalid trace command, expected start, stop, clear or dump <path>"};
+
+    return {};
+}
+
+} // namespace trace
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <hyprland/src/SharedDefs.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Opt-in tracing of hyprtile's work into a lock-free in-memory ring buffer, dumped as Chrome trace
+// JSON so it can be lined up with Hyprland's frames in Perfetto. Timestamps use CLOCK_MONOTONIC.
+namespace trace
+{
+
+inline std::atomic<bool> tracing_enabled = false;
+
+inline bool enabled()
+{
+    return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t now_ns();
+
+// name must outlive the trace (string literals, dispatcher names)
+void record(const char *name, int64_t id, uint64_t begin_ns, uint64_t end_ns);
+
+// Plugin load phases, kept even though tracing is never on while loading and written first in every dump
+void record_load(const char *name, uint64_t begin_ns, uint64_t end_ns);
+
+void start();
+void stop();
+void clear();
+bool dump(const std::string &path, std::string &error);
+
+// hyprtile:trace <start|stop|clear|dump path>
+SDispatchResult dispatch_trace(std::string arg);
+
+// Records one begin/end event spanning the lifetime of the scope
+class CScope
+{
+  public:
+    explicit CScope(const char *name, int64_t id = -1)
+        : name(enabled() ? name : nullptr), id(id), begin(this->name ? now_ns() : 0)
+    {
+    }
+
+    ~CScope()
+    {
+        if (name)
+            record(name, id, begin, now_ns());
+    }
+
+    CScope(const CScope &) = delete;
+    CScope &operator=(const CScope &) = delete;
+
+  private:
+    const char *name;
+    int64_t id;
+    uint64_t begin;
+};
+
+} // namespace trace
+
+#define HT_TRACE_CONCAT_IMPL(a, b) a##b
+#define HT_TRACE_CONCAT(a, b) HT_TRACE_CONCAT_IMPL(a, b)
+// HT_TRACE_SCOPE("name") or HT_TRACE_SCOPE("name", id)
+#define HT_TRACE_SCOPE(...) trace::CScope HT_TRACE_CONCAT(ht_trace_scope_, __LINE__)(__VA_ARGS__)
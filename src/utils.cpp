@@ -1,5 +1,8 @@
 #include "utils.h"
 
+#include "hyprland/src/Compositor.hpp"
+#include "hyprland/src/helpers/MiscFunctions.hpp"
+#include "hyprland/src/helpers/Monitor.hpp"
 #include "hyprland/src/plugins/PluginAPI.hpp"
 
 std::string remove_padding(const std::string &name)
@@ -77,6 +80,16 @@ std::string get_workspace_name(int column_id, int index)
     }
 }
 
+PHLWORKSPACE get_or_create_workspace(const std::string &name, const PHLMONITOR &monitor)
+{
+    const auto result = getWorkspaceIDNameFromString("name:" + name);
+    const PHLWORKSPACE workspace = g_pCompositor->getWorkspaceByID(result.id);
+    if (workspace || !monitor)
+        return workspace;
+
+    return g_pCompositor->createNewWorkspace(result.id, monitor->m_id, result.name, false);
+}
+
 // when I am too lazy to use logging
 void notify(const std::string &message)
 {
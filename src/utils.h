@@ -1,5 +1,7 @@
 #pragma once
 
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+
 #include <cmath>
 #include <string>
 
@@ -9,4 +11,7 @@ int name_to_column(const std::string &name);
 int name_to_index(const std::string &name);
 std::string get_workspace_name(int column_id, int index);
 
+// Workspace called name, created on monitor if it doesn't exist yet
+PHLWORKSPACE get_or_create_workspace(const std::string &name, const PHLMONITOR &monitor);
+
 void notify(const std::string &message);
@@ -0,0 +1,76 @@
+#include "workspace_pool.h"
+
+#include <algorithm>
+#include <deque>
+#include <hyprland/src/config/ConfigValue.hpp>
+#include <hyprland/src/desktop/Workspace.hpp>
+#include <hyprland/src/helpers/Monitor.hpp>
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+#include "globals.h"
+#include "utils.h"
+
+namespace workspace_pool
+{
+
+// Most recently left first
+static std::deque<PHLWORKSPACE> pool;
+
+void init_config()
+{
+    HyprlandAPI::addConfigValue(PHANDLE, "plugin:hyprtile:workspace_pool_size", Hyprlang::INT{0});
+}
+
+static size_t capacity()
+{
+    static auto PPOOLSIZE = CConfigValue<Hyprlang::INT>("plugin:hyprtile:workspace_pool_size");
+    return std::max<Hyprlang::INT>(0, *PPOOLSIZE);
+}
+
+void park(const PHLWORKSPACE &workspace)
+{
+    if (!workspace || workspace->m_isSpecialWorkspace)
+        return;
+
+    // workspaces that got windows in the meantime are kept alive by them, free their slot
+    std::erase_if(pool, [&workspace](const PHLWORKSPACE &ws) { return ws == workspace || ws->getWindows() > 0; });
+
+    if (workspace->getWindows() > 0 || name_to_column(workspace->m_name) == -1)
+        return;
+
+    const size_t max_size = capacity();
+    if (max_size == 0)
+        return;
+
+    pool.push_front(workspace);
+
+    // dropping the last reference lets Hyprland clean the workspace up as usual
+    while (pool.size() > max_size)
+        pool.pop_back();
+}
+
+bool is_parked(const PHLWORKSPACE &workspace)
+{
+    if (!workspace || workspace->getWindows() > 0)
+        return false;
+
+    const PHLMONITOR monitor = workspace->m_monitor.lock();
+    if (monitor && monitor->m_activeWorkspace == workspace)
+        return false;
+
+    return std::ranges::find(pool, workspace) != pool.end();
+}
+
+void release_column(int column)
+{
+    std::erase_if(pool, [column](const PHLWORKSPACE &ws) {
+        return name_to_column(ws->m_name) == column && is_parked(ws);
+    });
+}
+
+void clear()
+{
+    pool.clear();
+}
+
+} // namespace workspace_pool
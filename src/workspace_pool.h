@@ -0,0 +1,24 @@
+#pragma once
+
+#include <hyprland/src/desktop/DesktopTypes.hpp>
+
+// Keeps recently left empty sub-workspaces alive so walking up and down a column does not
+// destroy and recreate them (and their layout state) on every step
+namespace workspace_pool
+{
+
+void init_config();
+
+// Hold a reference to an empty workspace that was just left, evicting the least recently used one
+void park(const PHLWORKSPACE &workspace);
+
+// True if the workspace is empty, not shown and only alive because the pool holds it
+bool is_parked(const PHLWORKSPACE &workspace);
+
+// Drop the pool's references to the parked workspaces of column so Hyprland destroys them. Needed before renaming
+// workspaces in that column, a parked workspace would otherwise keep a name another one is renamed to
+void release_column(int column);
+
+void clear();
+
+} // namespace workspace_pool